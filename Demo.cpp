@@ -2,17 +2,45 @@
 // Created by andrew on 22.11.17.
 //
 #include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include <chrono>
+#include <cctype>
 #include "Demo.h"
+#include "SortInsert.h"
+#include "core/Parallel.h"
+#include "core/External.h"
+#include "core/Ingest.h"
+#include "core/Generator.h"
+#include "core/Select.h"
+#include "core/Strings.h"
+#include "core/Simd.h"
 #include <Fl/Fl_File_Chooser.H>
+#include <Fl/Fl_Progress.H>
+#include <Fl/Fl_Choice.H>
+#include <Fl/Fl_Int_Input.H>
+
+namespace {
+//Файлы крупнее этого не показываются по шагам, а сортируются во внешней памяти
+const long visual_limit=1<<20;
+//Алгоритмы, у которых есть своя кнопка; их варианты выбираются в диалоге
+const sortcore::Algorithm buttons[]={sortcore::Algorithm::Insertion, sortcore::Algorithm::Shell,
+                                     sortcore::Algorithm::Quick, sortcore::Algorithm::Heap,
+                                     sortcore::Algorithm::Radix, sortcore::Algorithm::ParallelQuick,
+                                     sortcore::Algorithm::Auto, sortcore::Algorithm::Tim,
+                                     sortcore::Algorithm::Partial};
+}
 
 Demo::Demo() : Fl_Widget(0,0,1200,600)
 {
-    int x0=-190, y0=200;
-    for(int i=1;i<=5;i++)
+    //по три кнопки в ряд
+    for(int i=0;i<(int)(sizeof(buttons)/sizeof(buttons[0]));i++)
     {
-        t.push_back(new Fl_Button(x0+=270,y0,230,50));
-        t[i-1]->color(FL_LIGHT3);
-        if(i==3) { y0+=100; x0=-55; }
+        t.push_back(new Fl_Button(80+270*(i%3),150+80*(i/3),230,50));
+        t[i]->color(FL_LIGHT3);
     }
     ibt();
     hide();
@@ -29,22 +57,20 @@ void Demo::show()
 }
 
 void Demo::ibt() {
-    t[0]->label("Сортировка Вставками");
-    t[1]->label("Сортировка Шелла");
-    t[2]->label("Быстрая Сортировка");
-    t[3]->label("Пирамидальная Сортировка");
-    t[4]->label("Поразрядная Сортировка");
-    for(int i=0;i<5;i++)
+    for(int i=0;i<(int)t.size();i++)
     {
-        t[i]->callback(choose);
+        t[i]->label(sortcore::name(buttons[i]));
+        t[i]->callback(choose,this);
     }
 }
 
 Demo::~Demo() {
     for(auto var : t) delete var;
+    delete sw;
 }
 
-void Demo::choose(Fl_Widget *w, void*) {
+void Demo::choose(Fl_Widget *w, void *ptr) {
+    auto *d=(Demo*)ptr;
     int wt=-1;
     wt=fl_choice(w->label(),"Из файла", "Случайно",nullptr);
     const char *fn;
@@ -57,6 +83,190 @@ void Demo::choose(Fl_Widget *w, void*) {
             Fl::wait();
         }
         fn=ch.value();
-        if(ch.value()==nullptr) Demo::choose(w,nullptr);
+        if(ch.value()==nullptr) return Demo::choose(w,ptr);
+    }
+    if(wt==0 && !sortcore::is_binary_name(fn) && textual(fn)) {
+        lines(fn);
+        return;
+    }
+    if(wt==0 && std::ifstream(fn,std::ios::binary|std::ios::ate).tellg()>visual_limit) {
+        int act=fl_choice("Файл слишком велик для демонстрации.\nЧто с ним сделать?","Ничего",
+                          "Внешняя сортировка","Первые k");
+        if(act==1) external(fn);
+        if(act==2) topk(fn);
+        return;
+    }
+    std::vector<int> v;
+    if(wt==0) {
+        try {
+            v=sortcore::read_ints(fn);
+        }
+        catch(const std::exception &e) {
+            fl_alert("%s",e.what());
+            return;
+        }
+    }
+    else if(!generator(v)) return;
+    d->choosedsort=(int)(std::find(d->t.begin(),d->t.end(),w)-d->t.begin());
+    sortcore::Algorithm a=buttons[d->choosedsort];
+    sortcore::Options opt;
+    opt.counters=true;
+    if(a==sortcore::Algorithm::ParallelQuick && fl_choice("Вариант","Быстрая","По выборке",nullptr)==1)
+        a=sortcore::Algorithm::SampleSort;
+    if(a==sortcore::Algorithm::ParallelQuick || a==sortcore::Algorithm::SampleSort) {
+        std::string def=std::to_string(sortcore::threads_or_default(0));
+        const char *th=fl_input("Число потоков",def.c_str());
+        if(th!=nullptr && std::atoi(th)>0) opt.threads=(unsigned)std::atoi(th);
+    }
+    if(a==sortcore::Algorithm::Shell) {
+        //в диалоге три кнопки, поэтому редкие последовательности -- вторым шагом
+        int g=fl_choice("Шаги","Циура","Токуда","Другие...");
+        const sortcore::GapSequence more[]={sortcore::GapSequence::Shell, sortcore::GapSequence::Knuth,
+                                            sortcore::GapSequence::Sedgewick};
+        if(g==2) opt.gaps=more[fl_choice("Шаги","Шелл","Кнут","Седжвик")];
+        else opt.gaps=g==0 ? sortcore::GapSequence::Ciura : sortcore::GapSequence::Tokuda;
+    }
+    if(a==sortcore::Algorithm::Partial) {
+        std::string def=std::to_string(std::min<std::size_t>(opt.k,v.size()/4+1));
+        const char *k=fl_input("Сколько первых мест упорядочить",def.c_str());
+        if(k==nullptr) return;
+        if(std::atoi(k)>0) opt.k=(std::size_t)std::atoi(k);
+    }
+    if(a==sortcore::Algorithm::Heap)
+        opt.heap=sortcore::heap_variants[fl_choice("Вариант","Двоичная","Снизу вверх","4-арная")];
+    if(a==sortcore::Algorithm::Quick) {
+        //векторное ядро выбирается по процессору само; в заголовке -- какое
+        const sortcore::Algorithm quick[]={sortcore::Algorithm::Quick, sortcore::Algorithm::Pdq,
+                                           sortcore::Algorithm::Simd};
+        a=quick[fl_choice("Вариант (векторные инструкции: %s)","Классическая","pdqsort","Векторная",
+                          sortcore::name(sortcore::simd_level()))];
+        if(a==sortcore::Algorithm::Quick)
+            opt.partition=sortcore::partition_schemes[fl_choice("Разбиение","Хоара","Блочное",nullptr)];
+    }
+    if(a==sortcore::Algorithm::Radix && fl_choice("Вариант","LSD","MSD на месте",nullptr)==1)
+        a=sortcore::Algorithm::MsdRadix;
+    if(a==sortcore::Algorithm::Radix) {
+        const unsigned bits[]={8,11,16};
+        opt.radix_bits=bits[fl_choice("Ширина разряда","8 бит","11 бит","16 бит")];
+    }
+    delete d->sw;
+    if(a==sortcore::Algorithm::Insertion) d->sw=new SortInsert(v);
+    else d->sw=new SortWindow(a,v,opt);
+    if(wt==0) d->sw->setfile((char*)fn);
+}
+
+void Demo::external(const char *fn) {
+    const char *mb=fl_input("Бюджет памяти, МБ","256");
+    if(mb==nullptr) return;
+    sortcore::ExternalOptions opt;
+    if(std::atoi(mb)>0) opt.memory=(std::size_t)std::atoi(mb)<<20;
+    Fl_Window win(400,80,"Внешняя сортировка");
+    Fl_Progress bar(20,25,360,30);
+    bar.minimum(0);
+    bar.maximum(1);
+    win.end();
+    win.show();
+    //сортировка идёт в этом же потоке, поэтому окно обновляем из колбэка
+    opt.progress=[&bar](double x) {
+        bar.value((float)x);
+        Fl::check();
+    };
+    std::string out=std::string(fn)+".sorted";
+    try {
+        sortcore::ExternalStats st=sortcore::external_sort(fn,out,opt);
+        win.hide();
+        fl_message("Отсортировано чисел: %llu\nРезультат: %s\nКусков: %u, проходов слияния: %u",
+                   (unsigned long long)st.elements,out.c_str(),(unsigned)st.runs,st.passes);
     }
+    catch(const std::exception &e) {
+        win.hide();
+        fl_alert("%s",e.what());
+    }
+}
+
+bool Demo::textual(const char *fn) {
+    //по началу файла: буквы или не-ASCII байты -- значит, не список чисел
+    char head[4096];
+    std::ifstream in(fn,std::ios::binary);
+    in.read(head,sizeof(head));
+    for(std::streamsize i=0;i<in.gcount();i++)
+    {
+        unsigned char c=(unsigned char)head[i];
+        if(c>=0x80 || std::isalpha(c)) return true;
+    }
+    return false;
+}
+
+void Demo::lines(const char *fn) {
+    int alg=fl_choice("Файл со строками. Как сортировать?","Отмена","Трёхпутевая быстрая","MSD по байтам");
+    if(alg==0) return;
+    std::string out=std::string(fn)+".sorted";
+    try {
+        auto t0=std::chrono::steady_clock::now();
+        sortcore::StringArena a=sortcore::StringArena::read(fn);
+        auto t1=std::chrono::steady_clock::now();
+        if(alg==1) sortcore::multikey_sort(a.keys());
+        else sortcore::string_radix_sort(a.keys());
+        auto t2=std::chrono::steady_clock::now();
+        a.write(out);
+        fl_message("Отсортировано строк: %llu\nЧтение: %.0f мс, сортировка: %.0f мс\nРезультат: %s",
+                   (unsigned long long)a.size(),std::chrono::duration<double,std::milli>(t1-t0).count(),
+                   std::chrono::duration<double,std::milli>(t2-t1).count(),out.c_str());
+    }
+    catch(const std::exception &e) {
+        fl_alert("%s",e.what());
+    }
+}
+
+void Demo::topk(const char *fn) {
+    const char *k=fl_input("Сколько наименьших чисел отобрать","1000");
+    if(k==nullptr || std::atoi(k)<=0) return;
+    //файл читается потоком через отображение: в памяти только k отобранных
+    sortcore::TopK<int> top((std::size_t)std::atoi(k));
+    std::string out=std::string(fn)+".top";
+    try {
+        sortcore::IntFile f(fn);
+        if(f.binary()) top.push(f.data(),f.data()+f.count());
+        else {
+            const char *p=f.bytes(), *end=p+f.size();
+            int x;
+            while(sortcore::parse_int(p,end,x)) top.push(x);
+        }
+        std::ofstream o(out);
+        for(int x : top.sorted()) o<<x<<'\n';
+        if(!o) throw std::runtime_error("Не удалось записать "+out);
+    }
+    catch(const std::exception &e) {
+        fl_alert("%s",e.what());
+        return;
+    }
+    fl_message("Отобрано чисел: %u\nРезультат: %s",(unsigned)top.size(),out.c_str());
+}
+
+bool Demo::generator(std::vector<int> &v) {
+    Fl_Window win(380,210,"Генератор");
+    Fl_Choice dist(150,20,210,25,"Распределение");
+    Fl_Int_Input size(150,60,210,25,"Размер");
+    Fl_Int_Input seed(150,100,210,25,"Зерно");
+    Fl_Button ok(150,150,100,35,"Создать");
+    win.end();
+    for(auto d : sortcore::distributions) dist.add(sortcore::name(d));
+    dist.value(0);
+    size.value("30");
+    seed.value("1");
+    bool accepted=false;
+    ok.callback([](Fl_Widget *w, void *ptr) {
+        *(bool*)ptr=true;
+        w->window()->hide();
+    },&accepted);
+    win.show();
+    while(win.shown()) Fl::wait();
+    if(!accepted) return false;
+    sortcore::GeneratorOptions opt;
+    opt.dist=sortcore::distributions[dist.value()];
+    opt.seed=std::strtoull(seed.value(),nullptr,10);
+    long n=std::atol(size.value());
+    if(n<=0) return false;
+    v=sortcore::generate((std::size_t)n,opt);
+    return true;
 }
@@ -8,12 +8,19 @@
 #include <FL/Fl_Button.H>
 #include <vector>
 #include <Fl/fl_ask.H>
+#include "SortWindow.h"
 
 class Demo:public Fl_Widget{
     std::vector<Fl_Widget*>t;
     int choice, choosedsort;
+    SortWindow *sw=nullptr;
     void ibt();
     static void choose(Fl_Widget *w, void*);
+    static void external(const char *fn);
+    static void topk(const char *fn);
+    static bool textual(const char *fn);
+    static void lines(const char *fn);
+    static bool generator(std::vector<int> &v);
     void draw() override {}
 public:
     Demo();
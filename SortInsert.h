@@ -9,7 +9,7 @@
 
 class SortInsert: public SortWindow{
 public:
-    SortInsert() {
+    explicit SortInsert(std::vector<int> v) : SortWindow(sortcore::Algorithm::Insertion,std::move(v)) {
 
     }
 };
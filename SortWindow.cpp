@@ -3,10 +3,66 @@
 //
 
 #include "SortWindow.h"
+#include <algorithm>
+#include <FL/Fl.H>
+
+SortWindow::SortWindow(sortcore::Algorithm a, std::vector<int> v, const sortcore::Options &opt)
+        : b(a,std::move(v),opt) {
+    win=new Fl_Window(1000,600,sortcore::name(a));
+    canvas=new Canvas(20,20,960,400,this);
+    t=new Fl_Multiline_Output(20,440,700,140);
+    bt1=new Fl_Button(740,440,110,35);
+    bt2=new Fl_Button(870,440,110,35);
+    bt3=new Fl_Button(740,490,240,35);
+    ibt();
+    win->end();
+    showstate();
+    win->show();
+}
+
+SortWindow::~SortWindow() {
+    Fl::remove_timeout(tick,this);
+    delete win;
+}
 
 void SortWindow::ibt() {
     bt1->label("Предыдущее");
     bt2->label("Следующее");
+    bt1->callback(prev,this);
+    bt2->callback(next,this);
+    bt3->label("Автовоспроизведение");
+    bt3->callback(play,this);
+}
+
+void SortWindow::prev(Fl_Widget *w, void *ptr) {
+    auto *sw=(SortWindow*)ptr;
+    if(sw->k>0) sw->k--;
+    sw->showstate();
+}
+
+void SortWindow::next(Fl_Widget *w, void *ptr) {
+    auto *sw=(SortWindow*)ptr;
+    //следующий шаг вычисляется только сейчас, ядро ждёт в очереди упреждения
+    if(sw->b.fetch(sw->k+1)) sw->k++;
+    sw->showstate();
+}
+
+void SortWindow::play(Fl_Widget *w, void *ptr) {
+    auto *sw=(SortWindow*)ptr;
+    sw->autoplay=!sw->autoplay;
+    if(sw->autoplay) Fl::add_timeout(0.05,tick,sw);
+    else Fl::remove_timeout(tick,sw);
+}
+
+void SortWindow::tick(void *ptr) {
+    auto *sw=(SortWindow*)ptr;
+    if(!sw->b.fetch(sw->k+1)) {
+        sw->autoplay=false;
+        return;
+    }
+    sw->k++;
+    sw->showstate();
+    Fl::repeat_timeout(0.05,tick,sw);
 }
 
 void SortWindow::setfile(char *name) {
@@ -17,14 +73,42 @@ std::string SortWindow::getfile() {
     return filename;
 }
 
-void SortWindow::addState(State a) {
-    b.push_back(a);
-}
-
 State SortWindow::current() {
-    return b[k];
+    return b.state(k);
 }
 
 void SortWindow::showstate() {
-    t->value(b[k].statestr);
+    t->value(b.text(k).c_str());
+    canvas->redraw();
+}
+
+void SortWindow::draw() {
+    //столбики высотой по значению, затронутая на шаге пара выделена красным;
+    //если элементов больше, чем пикселей, в столбце рисуется максимум
+    const std::vector<int> &cur=b.at(k);
+    std::pair<int,int> sw=b.touched(k);
+    int x=canvas->x(), y=canvas->y(), w=canvas->w(), h=canvas->h();
+    fl_color(FL_WHITE);
+    fl_rectf(x,y,w,h);
+    if(cur.empty()) return;
+    auto mm=std::minmax_element(cur.begin(),cur.end());
+    long long lo=std::min(0,*mm.first), span=(long long)*mm.second-lo+1;
+    long long n=(long long)cur.size();
+    for(long long i=0;i<n;)
+    {
+        int x0=x+(int)(w*i/n);
+        int top=cur[i];
+        bool hit=false;
+        long long j=i;
+        for(;j<n && x+(int)(w*j/n)==x0;j++)
+        {
+            top=std::max(top,cur[j]);
+            hit=hit || j==sw.first || j==sw.second;
+        }
+        int x1=x+(int)(w*j/n);
+        int bh=(int)((top-lo+1)*h/span);
+        fl_color(hit ? FL_RED : FL_BLUE);
+        fl_rectf(x0,y+h-bh,std::max(1,x1-x0-1),bh);
+        i=j;
+    }
 }
@@ -11,29 +11,40 @@
 #include <FL/Fl_Button.H>
 #include <Fl/Fl_Multiline_Output.H>
 #include <Fl/fl_draw.H>
-
-struct State{
-    std::vector<int> cur;
-    char statestr[255];
-    std::pair<int,int> sw;
-};
+#include "core/State.h"
+#include "core/Playback.h"
+#include "core/Algorithm.h"
 
 class SortWindow {
+    //Полотно внутри окна, отрисовку делегирует SortWindow::draw
+    class Canvas:public Fl_Widget{
+        SortWindow *owner;
+        void draw() override { owner->draw(); }
+    public:
+        Canvas(int x, int y, int w, int h, SortWindow *owner) : Fl_Widget(x,y,w,h), owner(owner) {}
+    };
     Fl_Window *win=nullptr;
-    std::vector<State> b;
-    int k;
-    Fl_Button *bt1, *bt2;
+    sortcore::Playback b;
+    int k=0;
+    Fl_Button *bt1, *bt2, *bt3;
+    bool autoplay=false;
     Fl_Multiline_Output *t;
     std::string filename;
     void ibt();
+    static void prev(Fl_Widget *w, void *ptr);
+    static void next(Fl_Widget *w, void *ptr);
+    static void play(Fl_Widget *w, void *ptr);
+    static void tick(void *ptr);
+protected:
+    Canvas *canvas;
 public:
-
+    SortWindow(sortcore::Algorithm a, std::vector<int> v, const sortcore::Options &opt=sortcore::Options());
+    virtual ~SortWindow();
     void setfile(char *name);
     std::string getfile();
-    void addState(State a);
     State current();
     virtual void showstate();
-    virtual void draw()=0;
+    virtual void draw();
 };
 
 
@@ -0,0 +1,165 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Algorithm.h"
+#include <cstdio>
+#include "Dispatch.h"
+
+namespace sortcore {
+
+const char *name(Algorithm a)
+{
+    switch(a)
+    {
+        case Algorithm::Insertion: return "Сортировка Вставками";
+        case Algorithm::Shell: return "Сортировка Шелла";
+        case Algorithm::Quick: return "Быстрая Сортировка";
+        case Algorithm::Heap: return "Пирамидальная Сортировка";
+        case Algorithm::Radix: return "Поразрядная Сортировка";
+        case Algorithm::ParallelQuick: return "Параллельная Быстрая";
+        case Algorithm::MsdRadix: return "Поразрядная MSD на месте";
+        case Algorithm::Pdq: return "Pattern-defeating Quicksort";
+        case Algorithm::Auto: return "Автовыбор";
+        case Algorithm::Tim: return "Устойчивая Слиянием";
+        case Algorithm::Partial: return "Частичная Сортировка";
+        case Algorithm::SampleSort: return "Параллельная по Выборке";
+        case Algorithm::Simd: return "Векторная Быстрая";
+    }
+    return "";
+}
+
+const char *id(Algorithm a)
+{
+    switch(a)
+    {
+        case Algorithm::Insertion: return "insertion";
+        case Algorithm::Shell: return "shell";
+        case Algorithm::Quick: return "quick";
+        case Algorithm::Heap: return "heap";
+        case Algorithm::Radix: return "radix";
+        case Algorithm::ParallelQuick: return "parallel_quick";
+        case Algorithm::MsdRadix: return "msd_radix";
+        case Algorithm::Pdq: return "pdq";
+        case Algorithm::Auto: return "auto";
+        case Algorithm::Tim: return "tim";
+        case Algorithm::Partial: return "partial";
+        case Algorithm::SampleSort: return "sample";
+        case Algorithm::Simd: return "simd";
+    }
+    return "";
+}
+
+const char *name(GapSequence g)
+{
+    switch(g)
+    {
+        case GapSequence::Shell: return "Шелл";
+        case GapSequence::Knuth: return "Кнут";
+        case GapSequence::Sedgewick: return "Седжвик";
+        case GapSequence::Tokuda: return "Токуда";
+        case GapSequence::Ciura: return "Циура";
+    }
+    return "";
+}
+
+const char *id(GapSequence g)
+{
+    switch(g)
+    {
+        case GapSequence::Shell: return "shell";
+        case GapSequence::Knuth: return "knuth";
+        case GapSequence::Sedgewick: return "sedgewick";
+        case GapSequence::Tokuda: return "tokuda";
+        case GapSequence::Ciura: return "ciura";
+    }
+    return "";
+}
+
+const char *name(HeapVariant h)
+{
+    switch(h)
+    {
+        case HeapVariant::Binary: return "Двоичная";
+        case HeapVariant::BottomUp: return "Снизу вверх";
+        case HeapVariant::Quaternary: return "4-арная";
+    }
+    return "";
+}
+
+const char *id(HeapVariant h)
+{
+    switch(h)
+    {
+        case HeapVariant::Binary: return "binary";
+        case HeapVariant::BottomUp: return "bottom_up";
+        case HeapVariant::Quaternary: return "quaternary";
+    }
+    return "";
+}
+
+const char *name(PartitionScheme p)
+{
+    switch(p)
+    {
+        case PartitionScheme::Hoare: return "Хоара";
+        case PartitionScheme::Block: return "Блочное";
+    }
+    return "";
+}
+
+const char *id(PartitionScheme p)
+{
+    switch(p)
+    {
+        case PartitionScheme::Hoare: return "hoare";
+        case PartitionScheme::Block: return "block";
+    }
+    return "";
+}
+
+std::string summary(const Stats &s)
+{
+    char buf[255];
+    std::snprintf(buf,sizeof(buf),"Массив отсортирован\nСравнений: %llu\nОбменов: %llu\nЗаписей: %llu",
+                  (unsigned long long)s.comparisons,(unsigned long long)s.swaps,(unsigned long long)s.writes);
+    return buf;
+}
+
+void sort(Algorithm a, std::vector<int> &v, const Options &opt)
+{
+    NoTrace tr;
+    run(a,v,opt,tr);
+}
+
+Stats count(Algorithm a, std::vector<int> &v, const Options &opt)
+{
+    CountTrace tr;
+    run(a,v,opt,tr);
+    return tr.stats;
+}
+
+PerfStats profile(Algorithm a, std::vector<int> &v, const Options &opt)
+{
+    NoTrace tr;
+    PerfCounters pc;
+    pc.start();
+    run(a,v,opt,tr);
+    return pc.stop();
+}
+
+Timeline trace(Algorithm a, std::vector<int> &v, const Options &opt)
+{
+    Timeline out(v);
+    std::vector<int> copy;
+    if(opt.counters) copy=v;
+    TimelineTrace tr(out);
+    run(a,v,opt,tr);
+    std::string last=summary(tr.stats);
+    //трассировка раздувает счётчики, поэтому меряем отдельный чистый прогон
+    if(opt.counters) last+="\n"+describe(profile(a,copy,opt));
+    out.note(last);
+    return out;
+}
+
+}
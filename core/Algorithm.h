@@ -0,0 +1,82 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_ALGORITHM_H
+#define SORT_ALGORITHM_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Perf.h"
+#include "Trace.h"
+#include "Timeline.h"
+
+namespace sortcore {
+
+enum class Algorithm{Insertion, Shell, Quick, Heap, Radix, ParallelQuick, MsdRadix, Pdq, Auto, Tim, Partial, SampleSort, Simd};
+
+//Все алгоритмы; варианты (как MsdRadix) Demo предлагает в диалоге основного
+const Algorithm algorithms[]={Algorithm::Insertion, Algorithm::Shell, Algorithm::Quick,
+                              Algorithm::Heap, Algorithm::Radix, Algorithm::ParallelQuick,
+                              Algorithm::MsdRadix, Algorithm::Pdq, Algorithm::Auto, Algorithm::Tim,
+                              Algorithm::Partial, Algorithm::SampleSort, Algorithm::Simd};
+
+//Последовательности шагов сортировки Шелла; политики -- в Shell.h
+enum class GapSequence{Shell, Knuth, Sedgewick, Tokuda, Ciura};
+
+const GapSequence gap_sequences[]={GapSequence::Shell, GapSequence::Knuth, GapSequence::Sedgewick,
+                                   GapSequence::Tokuda, GapSequence::Ciura};
+
+//Варианты пирамидальной сортировки из Heap.h
+enum class HeapVariant{Binary, BottomUp, Quaternary};
+
+const HeapVariant heap_variants[]={HeapVariant::Binary, HeapVariant::BottomUp, HeapVariant::Quaternary};
+
+//Разбиения быстрой сортировки из Quick.h
+enum class PartitionScheme{Hoare, Block};
+
+const PartitionScheme partition_schemes[]={PartitionScheme::Hoare, PartitionScheme::Block};
+
+//Настройки алгоритмов, которые можно менять из интерфейса
+struct Options{
+    unsigned threads=0; //0 -- по числу аппаратных потоков
+    unsigned radix_bits=8; //ширина разряда поразрядной сортировки: 8, 11 или 16
+    GapSequence gaps=GapSequence::Ciura; //шаги сортировки Шелла
+    HeapVariant heap=HeapVariant::Binary;
+    PartitionScheme partition=PartitionScheme::Hoare; //разбиение быстрой сортировки
+    std::size_t k=1000; //частичная сортировка: сколько первых мест упорядочить
+    bool counters=false; //дописать к итогу трассы аппаратные счётчики отдельного прогона без трассировки
+};
+
+const char *name(Algorithm a);
+
+//Короткий латинский идентификатор для командной строки и отчётов
+const char *id(Algorithm a);
+
+const char *name(GapSequence g);
+const char *id(GapSequence g);
+const char *name(HeapVariant h);
+const char *id(HeapVariant h);
+const char *name(PartitionScheme p);
+const char *id(PartitionScheme p);
+
+//Подпись последнего шага трассы
+std::string summary(const Stats &s);
+
+//Без трассировки, на полной скорости
+void sort(Algorithm a, std::vector<int> &v, const Options &opt=Options());
+
+//Только счётчики операций
+Stats count(Algorithm a, std::vector<int> &v, const Options &opt=Options());
+
+//Без трассировки под аппаратными счётчиками процессора
+PerfStats profile(Algorithm a, std::vector<int> &v, const Options &opt=Options());
+
+//Сортирует v и возвращает шаги для SortWindow: исходный массив, по шагу на
+//каждый обмен или запись и итоговый массив со счётчиками
+Timeline trace(Algorithm a, std::vector<int> &v, const Options &opt=Options());
+
+}
+
+#endif //SORT_ALGORITHM_H
@@ -0,0 +1,104 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Auto.h"
+#include <algorithm>
+#include "Simd.h"
+
+namespace sortcore {
+
+namespace {
+
+//Размер выборки: столько позиций смотрим независимо от длины массива
+const std::size_t sample_size=4096;
+//Короче этого выбирать нечего -- вставками
+const std::size_t auto_small=64;
+//Почти упорядоченный вход длиннее этого -- слиянием серий: редкие дальние
+//перестановки выборка не видит, а вставкам каждая стоит O(n)
+const std::size_t auto_presorted=1<<12;
+//С этой длины поразрядная обгоняет сравнения на данных без структуры
+const std::size_t auto_radix=1<<12;
+//Доля убывающих пар, ниже которой вход -- длинные серии для слияния
+const double auto_runs=0.1;
+//Доля повторов, при которой pdqsort со своим разбиением равных выгоднее
+const double auto_duplicates=0.5;
+
+//Число инверсий слиянием; x сортируется по пути
+std::size_t inversions(std::vector<int> &x, std::vector<int> &buf, std::size_t lo, std::size_t hi)
+{
+    if(hi-lo<2) return 0;
+    std::size_t mid=lo+(hi-lo)/2;
+    std::size_t r=inversions(x,buf,lo,mid)+inversions(x,buf,mid,hi);
+    std::size_t i=lo, j=mid, k=lo;
+    while(i<mid && j<hi)
+        if(x[j]<x[i]) { r+=mid-i; buf[k++]=x[j++]; }
+        else buf[k++]=x[i++];
+    while(i<mid) buf[k++]=x[i++];
+    while(j<hi) buf[k++]=x[j++];
+    std::copy(buf.begin()+lo,buf.begin()+hi,x.begin()+lo);
+    return r;
+}
+
+}
+
+Sample sample(const int *a, std::size_t n, std::size_t step)
+{
+    Sample s;
+    s.n=n;
+    if(n<2) return s;
+    step=std::max<std::size_t>(step,1);
+    std::vector<int> x;
+    std::size_t desc=0, pairs=0;
+    for(std::size_t i=0;i<n;i+=step)
+    {
+        x.push_back(a[i]);
+        if(i+1<n) { desc+=a[i+1]<a[i]; pairs++; }
+    }
+    s.size=x.size();
+    s.descents=pairs ? (double)desc/pairs : 0;
+    std::vector<int> buf(x.size());
+    double all=(double)x.size()*(x.size()-1)/2;
+    s.inversions=all>0 ? inversions(x,buf,0,x.size())/all : 0;
+    s.min=x.front();
+    s.max=x.back();
+    s.duplicates=1-(double)(std::unique(x.begin(),x.end())-x.begin())/s.size;
+    return s;
+}
+
+Choice auto_select(const std::vector<int> &v)
+{
+    Choice c;
+    std::size_t n=v.size();
+    c.s=sample(v.data(),n,n/sample_size);
+    if(n<=auto_small) {
+        c.algorithm=Algorithm::Insertion;
+        return c;
+    }
+    //ни одной дальней инверсии и редкие локальные: вставкам почти нечего двигать
+    if(c.s.inversions==0 && c.s.descents<=1.0/auto_small) {
+        c.algorithm=n<=auto_presorted ? Algorithm::Insertion : Algorithm::Tim;
+        return c;
+    }
+    //выборка лишь оценивает размах, перед подсчётом он уточняется полным проходом
+    if(c.s.max-c.s.min<(long long)n) {
+        auto mm=std::minmax_element(v.begin(),v.end());
+        if((long long)*mm.second-*mm.first<(long long)n) {
+            c.counting=true;
+            c.lo=*mm.first;
+            c.hi=*mm.second;
+            return c;
+        }
+    }
+    if(c.s.descents<auto_runs) {
+        c.algorithm=Algorithm::Tim;
+        return c;
+    }
+    bool plain=c.s.duplicates<auto_duplicates;
+    //векторная быстрая там, где процессор её поддерживает, иначе pdqsort
+    Algorithm cmp=simd_level()!=SimdLevel::Scalar ? Algorithm::Simd : Algorithm::Pdq;
+    c.algorithm=n>=auto_radix && plain ? Algorithm::Radix : cmp;
+    return c;
+}
+
+}
@@ -0,0 +1,42 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_AUTO_H
+#define SORT_AUTO_H
+
+#include <cstddef>
+#include <vector>
+#include "Algorithm.h"
+
+namespace sortcore {
+
+//Сводка о входе по выборке из size элементов
+struct Sample{
+    std::size_t n=0, size=0;
+    double descents=0; //доля убывающих соседних пар; серий примерно 1+n*descents
+    double inversions=0; //доля инверсий среди элементов выборки, разнесённых по массиву
+    double duplicates=0; //доля повторяющихся значений в выборке
+    long long min=0, max=0; //размах ключей в выборке
+};
+
+//Смотрит каждый step-й элемент и его соседа: O(n/step) чтений
+Sample sample(const int *a, std::size_t n, std::size_t step);
+
+//Решение автовыбора; counting -- сортировка подсчётом по [lo, hi]
+struct Choice{
+    Algorithm algorithm=Algorithm::Pdq;
+    bool counting=false;
+    long long lo=0, hi=0;
+    Sample s;
+};
+
+//Почти упорядоченный вход -- вставками (крупный -- слиянием серий), малый
+//размах ключей -- подсчётом, длинные серии -- слиянием серий, крупный массив
+//без частых повторов -- поразрядной, остальное -- векторной быстрой (без SIMD
+//-- pdqsort; с трассировкой run() тоже берёт pdqsort)
+Choice auto_select(const std::vector<int> &v);
+
+}
+
+#endif //SORT_AUTO_H
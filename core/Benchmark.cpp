@@ -0,0 +1,309 @@
+//
+// Created by andrew on 18.10.26.
+//
+//Замер алгоритмов по размерам и распределениям входа:
+//  bench [--algos=all|quick,pdq,...] [--dists=all|uniform,zipf,...]
+//        [--min=10] [--max=10000000] [--trials=5] [--threads=0] [--seed=1]
+//        [--k=1000] [--gaps=all|ciura,tokuda,...] [--heaps=all|binary,bottom_up,quaternary]
+//        [--partitions=all|hoare,block]
+//        [--format=csv|json] [--quadratic-limit=100000]
+//        [--no-counts] [--perf]
+//Размеры идут степенями десяти от min до max. На каждую точку -- trials
+//прогонов на разных входах (seed+номер прогона), время в нс на элемент со
+//средним, 95% доверительным интервалом и минимумом; отдельным прогоном со
+//счётчиками -- сравнения, обмены и записи; пик памяти -- по VmHWM. С --perf
+//каждый прогон идёт под аппаратными счётчиками, в отчёт попадает среднее на
+//элемент; недоступные счётчики остаются пустыми. Сортировка Шелла меряется
+//для каждой последовательности шагов из --gaps, пирамидальная -- для каждого
+//варианта из --heaps, быстрая -- для каждого разбиения из --partitions; они
+//пишутся в столбец variant. У векторной быстрой там -- выбранный набор
+//инструкций (SORT_SIMD=scalar|sse42 ограничивает его).
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Algorithm.h"
+#include "Generator.h"
+#include "Perf.h"
+#include "Simd.h"
+
+using namespace sortcore;
+
+namespace {
+
+struct Config{
+    std::vector<Algorithm> algos;
+    std::vector<Distribution> dists;
+    std::vector<GapSequence> gaps;
+    std::vector<HeapVariant> heaps;
+    std::vector<PartitionScheme> partitions;
+    std::size_t min=10, max=10000000, quadratic_limit=100000;
+    unsigned trials=5, threads=0;
+    std::size_t k=1000;
+    std::uint64_t seed=1;
+    bool json=false, counts=true, perf=false;
+};
+
+struct Row{
+    Algorithm a;
+    const char *variant;
+    Distribution d;
+    std::size_t n;
+    unsigned trials;
+    double mean, ci, best; //нс на элемент
+    bool counted;
+    Stats st;
+    long peak_kb, extra_kb;
+    PerfStats perf; //сумма по прогонам
+};
+
+//Пик RSS сбрасывается записью "5" в /proc/self/clear_refs (Linux 4.0+)
+void reset_peak()
+{
+    std::ofstream("/proc/self/clear_refs")<<"5";
+}
+
+long status_kb(const char *key)
+{
+    std::ifstream in("/proc/self/status");
+    std::string k;
+    long v=-1;
+    while(in>>k)
+        if(k==key) { in>>v; break; }
+    return v;
+}
+
+//Квантиль t-распределения Стьюдента 0.975 для dof степеней свободы
+double t975(unsigned dof)
+{
+    static const double t[]={0,12.706,4.303,3.182,2.776,2.571,2.447,2.365,2.306,2.262,2.228,
+                             2.201,2.179,2.160,2.145,2.131,2.120,2.110,2.101,2.093,2.086};
+    if(dof==0) return 0;
+    return dof<=20 ? t[dof] : 1.96;
+}
+
+template<class T>
+bool parse_list(const char *arg, const T *all, std::size_t count, const char *(*ident)(T), std::vector<T> &out)
+{
+    out.clear();
+    std::string s=arg;
+    if(s=="all") { out.assign(all,all+count); return true; }
+    for(std::size_t pos=0;pos<=s.size();)
+    {
+        std::size_t end=std::min(s.find(',',pos),s.size());
+        std::string item=s.substr(pos,end-pos);
+        std::size_t i=0;
+        while(i<count && item!=ident(all[i])) i++;
+        if(i==count)
+        {
+            std::fprintf(stderr,"unknown name: %s\n",item.c_str());
+            return false;
+        }
+        out.push_back(all[i]);
+        pos=end+1;
+    }
+    return true;
+}
+
+bool parse(int argc, char **argv, Config &c)
+{
+    const std::size_t na=sizeof(algorithms)/sizeof(algorithms[0]), nd=sizeof(distributions)/sizeof(distributions[0]);
+    c.algos.assign(algorithms,algorithms+na);
+    const std::size_t ng=sizeof(gap_sequences)/sizeof(gap_sequences[0]);
+    c.dists.assign(distributions,distributions+nd);
+    c.gaps.assign(gap_sequences,gap_sequences+ng);
+    const std::size_t nh=sizeof(heap_variants)/sizeof(heap_variants[0]);
+    c.heaps.assign(heap_variants,heap_variants+nh);
+    const std::size_t np=sizeof(partition_schemes)/sizeof(partition_schemes[0]);
+    c.partitions.assign(partition_schemes,partition_schemes+np);
+    for(int i=1;i<argc;i++)
+    {
+        const char *a=argv[i], *v=std::strchr(a,'=');
+        v=v ? v+1 : "";
+        auto is=[a](const char *opt) { return std::strncmp(a,opt,std::strlen(opt))==0; };
+        if(is("--algos=")) { if(!parse_list(v,algorithms,na,(const char*(*)(Algorithm))id,c.algos)) return false; }
+        else if(is("--dists=")) { if(!parse_list(v,distributions,nd,(const char*(*)(Distribution))id,c.dists)) return false; }
+        else if(is("--gaps=")) { if(!parse_list(v,gap_sequences,ng,(const char*(*)(GapSequence))id,c.gaps)) return false; }
+        else if(is("--heaps=")) { if(!parse_list(v,heap_variants,nh,(const char*(*)(HeapVariant))id,c.heaps)) return false; }
+        else if(is("--partitions=")) { if(!parse_list(v,partition_schemes,np,(const char*(*)(PartitionScheme))id,c.partitions)) return false; }
+        else if(is("--min=")) c.min=(std::size_t)std::strtod(v,nullptr);
+        else if(is("--max=")) c.max=(std::size_t)std::strtod(v,nullptr);
+        else if(is("--trials=")) c.trials=(unsigned)std::max(1,std::atoi(v));
+        else if(is("--threads=")) c.threads=(unsigned)std::atoi(v);
+        else if(is("--k=")) c.k=(std::size_t)std::strtod(v,nullptr);
+        else if(is("--seed=")) c.seed=std::strtoull(v,nullptr,10);
+        else if(is("--quadratic-limit=")) c.quadratic_limit=(std::size_t)std::strtod(v,nullptr);
+        else if(is("--format=")) c.json=std::strcmp(v,"json")==0;
+        else if(is("--no-counts")) c.counts=false;
+        else if(is("--perf")) c.perf=true;
+        else
+        {
+            std::fprintf(stderr,"usage: %s [--algos=..] [--dists=..] [--min=N] [--max=N] [--trials=N] [--threads=N]"
+                                " [--seed=N] [--k=N] [--gaps=..] [--heaps=..] [--partitions=..] [--format=csv|json] [--quadratic-limit=N] [--no-counts] [--perf]\n",argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool quadratic(Algorithm a)
+{
+    return a==Algorithm::Insertion;
+}
+
+//Проверка результата: частичная сортировка упорядочивает только первые k мест,
+//и дальше них нет ничего меньше
+bool done(Algorithm a, const Options &opt, const std::vector<int> &v)
+{
+    if(a!=Algorithm::Partial) return std::is_sorted(v.begin(),v.end());
+    auto mid=v.begin()+std::min(opt.k,v.size());
+    return std::is_sorted(v.begin(),mid) && (mid==v.begin() || mid==v.end() || *std::min_element(mid,v.end())>=mid[-1]);
+}
+
+//Настройки, с которыми меряется алгоритм, и их подписи для столбца variant
+void variants(const Config &c, Algorithm a, std::vector<Options> &opts, std::vector<const char*> &names)
+{
+    Options opt;
+    opt.threads=c.threads;
+    opt.k=c.k;
+    if(a==Algorithm::Shell)
+        for(GapSequence g : c.gaps) { opt.gaps=g; opts.push_back(opt); names.push_back(id(g)); }
+    else if(a==Algorithm::Heap)
+        for(HeapVariant h : c.heaps) { opt.heap=h; opts.push_back(opt); names.push_back(id(h)); }
+    else if(a==Algorithm::Quick)
+        for(PartitionScheme p : c.partitions) { opt.partition=p; opts.push_back(opt); names.push_back(id(p)); }
+    else if(a==Algorithm::Simd) { opts.push_back(opt); names.push_back(id(simd_level())); }
+    else { opts.push_back(opt); names.push_back(""); }
+}
+
+bool measure(const Config &c, Algorithm a, const char *variant, const Options &opt, Distribution d, std::size_t n, Row &r)
+{
+    GeneratorOptions g;
+    g.dist=d;
+    g.threads=c.threads;
+    std::vector<int> v(n);
+    std::vector<double> ns;
+    r=Row{a,variant,d,n,c.trials,0,0,0,false,Stats(),0,0,PerfStats()};
+    PerfCounters pc;
+    bool perf=c.perf && pc.available();
+    for(unsigned t=0;t<c.trials;t++)
+    {
+        g.seed=c.seed+t;
+        generate(v.data(),n,g);
+        long before=status_kb("VmRSS:");
+        reset_peak();
+        if(perf) pc.start();
+        auto t0=std::chrono::steady_clock::now();
+        sort(a,v,opt);
+        auto t1=std::chrono::steady_clock::now();
+        if(perf) {
+            PerfStats p=pc.stop();
+            for(unsigned i=0;i<counter_count;i++)
+            {
+                r.perf.value[i]+=p.value[i];
+                r.perf.valid[i]=p.valid[i] && (t==0 || r.perf.valid[i]);
+            }
+        }
+        long peak=status_kb("VmHWM:");
+        r.peak_kb=std::max(r.peak_kb,peak);
+        r.extra_kb=std::max(r.extra_kb,peak-before);
+        if(!done(a,opt,v))
+        {
+            std::fprintf(stderr,"%s%s%s left %s n=%zu unsorted\n",id(a),*variant ? "/" : "",variant,id(d),n);
+            return false;
+        }
+        ns.push_back(std::chrono::duration<double,std::nano>(t1-t0).count()/std::max<std::size_t>(n,1));
+    }
+    double sum=0, sq=0;
+    for(double x : ns) sum+=x;
+    r.mean=sum/ns.size();
+    for(double x : ns) sq+=(x-r.mean)*(x-r.mean);
+    r.ci=ns.size()>1 ? t975(ns.size()-1)*std::sqrt(sq/(ns.size()-1)/ns.size()) : 0;
+    r.best=*std::min_element(ns.begin(),ns.end());
+    if(c.counts)
+    {
+        g.seed=c.seed;
+        generate(v.data(),n,g);
+        r.st=count(a,v,opt);
+        r.counted=true;
+    }
+    return true;
+}
+
+//Среднее значение счётчика на элемент за один прогон
+double per_elem(const Row &r, unsigned i)
+{
+    return (double)r.perf.value[i]/r.trials/std::max<std::size_t>(r.n,1);
+}
+
+void print(const Config &c, const Row &r, bool first)
+{
+    if(c.json)
+    {
+        std::printf("%s  {\"algorithm\": \"%s\", \"variant\": \"%s\", \"distribution\": \"%s\", \"n\": %zu, "
+                    "\"trials\": %u, \"ns_per_elem\": %.4f, \"ci95\": %.4f, \"ns_per_elem_min\": %.4f, ",
+                    first ? "" : ",\n",id(r.a),r.variant,id(r.d),r.n,r.trials,r.mean,r.ci,r.best);
+        if(r.counted)
+            std::printf("\"comparisons\": %llu, \"swaps\": %llu, \"writes\": %llu, ",(unsigned long long)r.st.comparisons,
+                        (unsigned long long)r.st.swaps,(unsigned long long)r.st.writes);
+        for(unsigned i=0;i<counter_count;i++)
+            if(r.perf.valid[i]) std::printf("\"%s\": %.4f, ",id(counters[i]),per_elem(r,i));
+        std::printf("\"peak_kb\": %ld, \"extra_kb\": %ld}",r.peak_kb,r.extra_kb);
+    }
+    else
+    {
+        std::printf("%s,%s,%s,%zu,%u,%.4f,%.4f,%.4f,",id(r.a),r.variant,id(r.d),r.n,r.trials,r.mean,r.ci,r.best);
+        if(r.counted)
+            std::printf("%llu,%llu,%llu,",(unsigned long long)r.st.comparisons,(unsigned long long)r.st.swaps,
+                        (unsigned long long)r.st.writes);
+        else std::printf(",,,");
+        std::printf("%ld,%ld",r.peak_kb,r.extra_kb);
+        for(unsigned i=0;i<counter_count;i++)
+            if(r.perf.valid[i]) std::printf(",%.4f",per_elem(r,i));
+            else std::printf(",");
+        std::printf("\n");
+    }
+    std::fflush(stdout);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    Config c;
+    if(!parse(argc,argv,c)) return 2;
+    if(c.json) std::printf("[\n");
+    else {
+        std::printf("algorithm,variant,distribution,n,trials,ns_per_elem,ci95,ns_per_elem_min,comparisons,swaps,writes,peak_kb,extra_kb");
+        for(Counter k : counters) std::printf(",%s",id(k));
+        std::printf("\n");
+    }
+    if(c.perf && !PerfCounters().available())
+        std::fprintf(stderr,"perf_event_open unavailable (see /proc/sys/kernel/perf_event_paranoid)\n");
+    bool first=true;
+    for(std::size_t n=std::max<std::size_t>(c.min,1);n<=c.max;n*=10)
+        for(Algorithm a : c.algos)
+        {
+            if(quadratic(a) && n>c.quadratic_limit) continue;
+            std::vector<Options> opts;
+            std::vector<const char*> names;
+            variants(c,a,opts,names);
+            for(std::size_t k=0;k<opts.size();k++)
+                for(Distribution d : c.dists)
+                {
+                    Row r;
+                    if(!measure(c,a,names[k],opts[k],d,n,r)) return 1;
+                    print(c,r,first);
+                    first=false;
+                }
+        }
+    if(c.json) std::printf("\n]\n");
+    return 0;
+}
@@ -0,0 +1,53 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_COUNTING_H
+#define SORT_COUNTING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "Trace.h"
+
+namespace sortcore {
+
+//Подсчётом для целых ключей из [lo, hi]: O(n + hi-lo) времени и столько же
+//памяти под счётчики. Годится, когда размах не больше длины массива.
+//Записываются только элементы, которые поменялись.
+template<class RandomIt, class Trace>
+void counting_sort(RandomIt first, RandomIt last, long long lo, long long hi, Trace &tr)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    std::vector<std::size_t> count(std::size_t(hi-lo+1));
+    for(RandomIt it=first;it!=last;++it) count[std::size_t((long long)*it-lo)]++;
+    std::ptrdiff_t i=0;
+    for(std::size_t k=0;k<count.size();k++)
+        for(std::size_t c=count[k];c>0;c--,i++)
+        {
+            T v=T(lo+(long long)k);
+            if(first[i]==v) continue;
+            first[i]=v;
+            tr.write(i,first[i]);
+        }
+}
+
+template<class RandomIt, class Trace>
+void counting_sort(RandomIt first, RandomIt last, Trace &tr)
+{
+    if(first==last) return;
+    auto mm=std::minmax_element(first,last);
+    counting_sort(first,last,(long long)*mm.first,(long long)*mm.second,tr);
+}
+
+template<class RandomIt>
+void counting_sort(RandomIt first, RandomIt last)
+{
+    NoTrace tr;
+    counting_sort(first,last,tr);
+}
+
+}
+
+#endif //SORT_COUNTING_H
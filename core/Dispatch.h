@@ -0,0 +1,82 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_DISPATCH_H
+#define SORT_DISPATCH_H
+
+#include <functional>
+#include <vector>
+#include "Algorithm.h"
+#include "Insertion.h"
+#include "Shell.h"
+#include "Quick.h"
+#include "Heap.h"
+#include "Radix.h"
+#include "ParallelQuick.h"
+#include "MsdRadix.h"
+#include "Pdq.h"
+#include "Counting.h"
+#include "Auto.h"
+#include "Tim.h"
+#include "Select.h"
+#include "SampleSort.h"
+#include "Simd.h"
+
+namespace sortcore {
+
+//Запуск ядра, выбранного по Algorithm, с заданной политикой трассировки
+template<class Trace>
+void run(Algorithm a, std::vector<int> &v, const Options &opt, Trace &tr)
+{
+    std::less<> comp;
+    switch(a)
+    {
+        case Algorithm::Insertion: insertion_sort(v.begin(),v.end(),comp,tr); break;
+        case Algorithm::Shell:
+            switch(opt.gaps)
+            {
+                case GapSequence::Shell: shell_sort<ShellGaps>(v.begin(),v.end(),comp,tr); break;
+                case GapSequence::Knuth: shell_sort<KnuthGaps>(v.begin(),v.end(),comp,tr); break;
+                case GapSequence::Sedgewick: shell_sort<SedgewickGaps>(v.begin(),v.end(),comp,tr); break;
+                case GapSequence::Tokuda: shell_sort<TokudaGaps>(v.begin(),v.end(),comp,tr); break;
+                case GapSequence::Ciura: shell_sort<CiuraGaps>(v.begin(),v.end(),comp,tr); break;
+            }
+            break;
+        case Algorithm::Quick:
+            switch(opt.partition)
+            {
+                case PartitionScheme::Hoare: quick_sort(v.begin(),v.end(),comp,tr); break;
+                case PartitionScheme::Block: block_quick_sort(v.begin(),v.end(),comp,tr); break;
+            }
+            break;
+        case Algorithm::Heap:
+            switch(opt.heap)
+            {
+                case HeapVariant::Binary: heap_sort(v.begin(),v.end(),comp,tr); break;
+                case HeapVariant::BottomUp: bottom_up_heap_sort(v.begin(),v.end(),comp,tr); break;
+                case HeapVariant::Quaternary: heap4_sort(v.begin(),v.end(),comp,tr); break;
+            }
+            break;
+        case Algorithm::Radix: radix_sort(v.begin(),v.end(),tr,opt.radix_bits,opt.threads); break;
+        case Algorithm::ParallelQuick: parallel_quick_sort(v.begin(),v.end(),comp,tr,opt.threads); break;
+        case Algorithm::SampleSort: sample_sort(v.begin(),v.end(),comp,tr,opt.threads); break;
+        case Algorithm::MsdRadix: msd_radix_sort(v.begin(),v.end(),tr); break;
+        case Algorithm::Pdq: pdq_sort(v.begin(),v.end(),comp,tr); break;
+        case Algorithm::Simd: simd_sort(v.data(),v.data()+v.size(),tr); break;
+        case Algorithm::Tim: tim_sort(v.begin(),v.end(),comp,tr); break;
+        case Algorithm::Partial: sort_first_k(v.begin(),v.end(),opt.k,comp,tr); break;
+        case Algorithm::Auto: {
+            Choice c=auto_select(v);
+            if(c.counting) counting_sort(v.begin(),v.end(),c.lo,c.hi,tr);
+            //векторное ядро по шагам не видно: трассе и счётчикам -- pdqsort
+            else if(Trace::enabled && c.algorithm==Algorithm::Simd) run(Algorithm::Pdq,v,opt,tr);
+            else run(c.algorithm,v,opt,tr);
+            break;
+        }
+    }
+}
+
+}
+
+#endif //SORT_DISPATCH_H
@@ -0,0 +1,60 @@
+//
+// Created by andrew on 18.10.26.
+//
+//Распределённая сортировка файла на локальных процессах-узлах:
+//  dsort [--workers=4] [--threads=1] [--oversampling=32] in out
+//Каждый узел пишет свою отсортированную долю в out.<узел> (для .bin --
+//<имя>.<узел>.bin). В stdout -- статистика разбиения по узлам в CSV и
+//итоговый дисбаланс: отношение самой большой доли к средней.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+#include "Distributed.h"
+
+using namespace sortcore;
+
+int main(int argc, char **argv)
+{
+    DistributedOptions opt;
+    std::vector<std::string> files;
+    for(int i=1;i<argc;i++)
+    {
+        const char *a=argv[i], *v=std::strchr(a,'=');
+        v=v ? v+1 : "";
+        auto is=[a](const char *o) { return std::strncmp(a,o,std::strlen(o))==0; };
+        if(is("--workers=")) opt.workers=(unsigned)std::max(1,std::atoi(v));
+        else if(is("--threads=")) opt.threads=(unsigned)std::atoi(v);
+        else if(is("--oversampling=")) opt.oversampling=(unsigned)std::max(1,std::atoi(v));
+        else if(a[0]!='-') files.push_back(a);
+        else files.clear(), i=argc;
+    }
+    if(files.size()!=2)
+    {
+        std::fprintf(stderr,"usage: %s [--workers=N] [--threads=N] [--oversampling=N] in out\n",argv[0]);
+        return 2;
+    }
+    DistributedStats st;
+    try {
+        st=distributed_sort(files[0],files[1],opt);
+    }
+    catch(const std::exception &e) {
+        std::fprintf(stderr,"%s\n",e.what());
+        return 1;
+    }
+    std::printf("rank,input,output,sent,received,sort_ms,exchange_ms,merge_ms,file\n");
+    for(std::size_t r=0;r<st.shards.size();r++)
+    {
+        const ShardStats &s=st.shards[r];
+        std::printf("%u,%llu,%llu,%llu,%llu,%.1f,%.1f,%.1f,%s\n",(unsigned)r,(unsigned long long)s.input,
+                    (unsigned long long)s.output,(unsigned long long)s.sent,(unsigned long long)s.received,
+                    s.sort_ms,s.exchange_ms,s.merge_ms,st.files[r].c_str());
+    }
+    std::printf("elements=%llu imbalance=%.4f\n",(unsigned long long)st.elements,st.imbalance());
+    return 0;
+}
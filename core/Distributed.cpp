@@ -0,0 +1,452 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Distributed.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "Ingest.h"
+#include "LoserTree.h"
+#include "SampleSort.h"
+
+namespace sortcore {
+
+double DistributedStats::imbalance() const
+{
+    if(shards.empty() || elements==0) return 1.0;
+    std::uint64_t most=0;
+    for(const ShardStats &s : shards) most=std::max(most,s.output);
+    return (double)most*shards.size()/elements;
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double ms(Clock::time_point a, Clock::time_point b)
+{
+    return std::chrono::duration<double,std::milli>(b-a).count();
+}
+
+void send_all(int fd, const void *p, std::size_t n)
+{
+    const char *c=static_cast<const char*>(p);
+    while(n)
+    {
+        ssize_t w=::write(fd,c,n);
+        if(w<0 && errno==EINTR) continue;
+        if(w<=0) throw std::runtime_error("обмен между узлами прерван");
+        c+=w;
+        n-=(std::size_t)w;
+    }
+}
+
+void recv_all(int fd, void *p, std::size_t n)
+{
+    char *c=static_cast<char*>(p);
+    while(n)
+    {
+        ssize_t r=::read(fd,c,n);
+        if(r<0 && errno==EINTR) continue;
+        if(r<=0) throw std::runtime_error("обмен между узлами прерван");
+        c+=r;
+        n-=(std::size_t)r;
+    }
+}
+
+void send_ints(int fd, const int *p, std::uint64_t n)
+{
+    send_all(fd,&n,sizeof(n));
+    send_all(fd,p,n*sizeof(int));
+}
+
+void recv_ints(int fd, std::vector<int> &v)
+{
+    std::uint64_t n;
+    recv_all(fd,&n,sizeof(n));
+    v.resize(n);
+    recv_all(fd,v.data(),n*sizeof(int));
+}
+
+//Ключ с разрешением равенства: значение, узел, позиция в отсортированной доле.
+//Все ключи различны, поэтому разделители режут и серии равных значений.
+struct Key{
+    int value;
+    std::uint32_t rank;
+    std::uint64_t pos;
+};
+
+bool operator<(const Key &a, const Key &b)
+{
+    if(a.value!=b.value) return a.value<b.value;
+    if(a.rank!=b.rank) return a.rank<b.rank;
+    return a.pos<b.pos;
+}
+
+//Узел: свой номер, сокеты к остальным узлам (peer[rank] не используется)
+struct Node{
+    unsigned rank, n;
+    std::vector<int> peer;
+};
+
+//Обмен "все со всеми" по кругу: в раунде d узел отправляет узлу rank+d и
+//принимает от rank-d, так что каждый раунд -- набор встречных пар и никто
+//не ждёт того, кто сам ждёт. Отправка идёт в отдельном потоке, иначе два
+//узла, одновременно пишущих друг другу больше буфера сокета, встанут.
+void rounds(Node &node, const std::function<void(int,unsigned)> &put, const std::function<void(int,unsigned)> &get)
+{
+    std::exception_ptr err;
+    std::thread sender([&] {
+        try {
+            for(unsigned d=1;d<node.n;d++)
+            {
+                unsigned to=(node.rank+d)%node.n;
+                put(node.peer[to],to);
+            }
+        }
+        catch(...) {
+            err=std::current_exception();
+        }
+    });
+    try {
+        for(unsigned d=1;d<node.n;d++)
+        {
+            unsigned from=(node.rank+node.n-d)%node.n;
+            get(node.peer[from],from);
+        }
+    }
+    catch(...) {
+        //будим застрявшую отправку, иначе join не вернётся
+        for(int fd : node.peer) if(fd>=0) ::shutdown(fd,SHUT_RDWR);
+        sender.join();
+        throw;
+    }
+    sender.join();
+    if(err) std::rethrow_exception(err);
+}
+
+//Разделители по выборкам всех узлов: выборка узла с n элементами из s штук
+//представляет n/s элементов, разделитель k ставится там, где накопленный вес
+//доходит до k/N всех элементов
+std::vector<Key> splitters(const std::vector<std::vector<Key>> &samples, const std::vector<std::uint64_t> &sizes,
+                           unsigned n)
+{
+    struct Weighted{ Key k; double w; };
+    std::vector<Weighted> all;
+    double total=0;
+    for(unsigned r=0;r<n;r++)
+    {
+        total+=(double)sizes[r];
+        for(const Key &k : samples[r]) all.push_back({k,(double)sizes[r]/samples[r].size()});
+    }
+    std::sort(all.begin(),all.end(),[](const Weighted &a, const Weighted &b) { return a.k<b.k; });
+    Key last={std::numeric_limits<int>::max(),std::numeric_limits<std::uint32_t>::max(),
+              std::numeric_limits<std::uint64_t>::max()};
+    std::vector<Key> split(n-1,last);
+    double cum=0;
+    std::size_t i=0;
+    for(unsigned k=1;k<n;k++)
+    {
+        double target=total*k/n;
+        while(i<all.size() && cum+all[i].w<target) cum+=all[i++].w;
+        if(i<all.size()) split[k-1]=all[i].k;
+    }
+    return split;
+}
+
+//Работа узла над своей долей a: локальная сортировка, разделители, обмен, слияние
+std::vector<int> shard(Node &node, std::vector<int> a, const DistributedOptions &opt, ShardStats &st)
+{
+    const unsigned n=node.n, rank=node.rank;
+    st.input=a.size();
+    auto t0=Clock::now();
+    sample_sort(a.begin(),a.end(),std::less<>(),opt.threads);
+    auto t1=Clock::now();
+    st.sort_ms=ms(t0,t1);
+
+    //регулярная выборка из середин равных долей отсортированного куска
+    std::uint64_t s=std::min<std::uint64_t>(a.size(),(std::uint64_t)std::max(1u,opt.oversampling)*n);
+    std::vector<std::vector<Key>> samples(n);
+    std::vector<std::uint64_t> sizes(n);
+    for(std::uint64_t i=0;i<s;i++)
+    {
+        std::uint64_t pos=(2*i+1)*a.size()/(2*s);
+        samples[rank].push_back({a[pos],rank,pos});
+    }
+    sizes[rank]=a.size();
+    rounds(node,[&](int fd, unsigned) {
+        std::uint64_t head[2]={sizes[rank],s};
+        send_all(fd,head,sizeof(head));
+        send_all(fd,samples[rank].data(),s*sizeof(Key));
+    },[&](int fd, unsigned from) {
+        std::uint64_t head[2];
+        recv_all(fd,head,sizeof(head));
+        sizes[from]=head[0];
+        samples[from].resize(head[1]);
+        recv_all(fd,samples[from].data(),head[1]*sizeof(Key));
+    });
+    std::vector<Key> split=splitters(samples,sizes,n);
+
+    //кусок для узла j -- ключи в (split[j-1], split[j]]
+    std::vector<std::size_t> bound(n+1,a.size());
+    bound[0]=0;
+    for(unsigned j=1;j<n;j++)
+    {
+        std::size_t lo=bound[j-1], hi=a.size();
+        while(lo<hi)
+        {
+            std::size_t mid=lo+(hi-lo)/2;
+            if(split[j-1]<Key{a[mid],rank,mid}) hi=mid;
+            else lo=mid+1;
+        }
+        bound[j]=lo;
+    }
+    std::vector<std::vector<int>> runs(n);
+    rounds(node,[&](int fd, unsigned to) {
+        send_ints(fd,a.data()+bound[to],bound[to+1]-bound[to]);
+        st.sent+=bound[to+1]-bound[to];
+    },[&](int fd, unsigned from) {
+        recv_ints(fd,runs[from]);
+        st.received+=runs[from].size();
+    });
+    runs[rank].assign(a.begin()+bound[rank],a.begin()+bound[rank+1]);
+    std::vector<int>().swap(a);
+    auto t2=Clock::now();
+    st.exchange_ms=ms(t1,t2);
+
+    std::vector<std::size_t> pos(n,0);
+    std::size_t total=0;
+    for(auto &r : runs) total+=r.size();
+    std::vector<int> out;
+    out.reserve(total);
+    auto less=[&](std::ptrdiff_t x, std::ptrdiff_t y) {
+        if(pos[y]==runs[y].size()) return pos[x]<runs[x].size();
+        return pos[x]<runs[x].size() && runs[x][pos[x]]<runs[y][pos[y]];
+    };
+    LoserTree<decltype(less)> lt((std::ptrdiff_t)n,less);
+    for(std::size_t i=0;i<total;i++)
+    {
+        std::ptrdiff_t w=lt.winner();
+        out.push_back(runs[w][pos[w]++]);
+        lt.replay(w);
+    }
+    st.output=out.size();
+    st.merge_ms=ms(t2,Clock::now());
+    return out;
+}
+
+//Запуск узлов. load(r) даёт долю узла r, store(r, доля) сохраняет результат;
+//при gather доли ещё и пересылаются родителю и собираются в *gather.
+DistributedStats launch(const DistributedOptions &opt, const std::function<std::vector<int>(unsigned)> &load,
+                        const std::function<void(unsigned,const std::vector<int>&)> &store, std::vector<int> *gather)
+{
+    const unsigned n=std::max(1u,opt.workers);
+    //mesh[i][j] -- конец сокета между i и j, принадлежащий i
+    std::vector<std::vector<int>> mesh(n,std::vector<int>(n,-1));
+    std::vector<int> ctl(n,-1), child(n,-1);
+    auto close_all=[&] {
+        for(auto &row : mesh) for(int &fd : row) if(fd>=0) { ::close(fd); fd=-1; }
+        for(unsigned r=0;r<n;r++)
+        {
+            if(ctl[r]>=0) ::close(ctl[r]);
+            if(child[r]>=0) ::close(child[r]);
+            ctl[r]=child[r]=-1;
+        }
+    };
+    auto pair=[&](int &a, int &b) {
+        int sv[2];
+        if(::socketpair(AF_UNIX,SOCK_STREAM,0,sv)!=0)
+        {
+            close_all();
+            throw std::runtime_error("не удалось создать сокеты узлов");
+        }
+        a=sv[0];
+        b=sv[1];
+    };
+    for(unsigned i=0;i<n;i++)
+        for(unsigned j=i+1;j<n;j++) pair(mesh[i][j],mesh[j][i]);
+    for(unsigned r=0;r<n;r++) pair(ctl[r],child[r]);
+
+    std::vector<pid_t> pid(n,-1);
+    for(unsigned r=0;r<n;r++)
+    {
+        pid[r]=::fork();
+        if(pid[r]==0)
+        {
+            //узел: оставляем только свои концы сокетов
+            std::signal(SIGPIPE,SIG_IGN);
+            Node node{r,n,mesh[r]};
+            int up=child[r];
+            for(unsigned i=0;i<n;i++)
+            {
+                for(unsigned j=0;j<n;j++) if(i!=r && mesh[i][j]>=0) ::close(mesh[i][j]);
+                ::close(ctl[i]);
+                if(i!=r) ::close(child[i]);
+            }
+            int code=0;
+            try {
+                ShardStats st;
+                std::vector<int> out=shard(node,load(r),opt,st);
+                if(store) store(r,out);
+                char ok=0;
+                send_all(up,&ok,1);
+                send_all(up,&st,sizeof(st));
+                if(gather) send_ints(up,out.data(),out.size());
+            }
+            catch(const std::exception &e) {
+                char fail=1;
+                std::uint32_t len=(std::uint32_t)std::strlen(e.what());
+                try {
+                    send_all(up,&fail,1);
+                    send_all(up,&len,sizeof(len));
+                    send_all(up,e.what(),len);
+                }
+                catch(...) {}
+                code=1;
+            }
+            //без деструкторов и atexit родителя
+            ::_exit(code);
+        }
+        if(pid[r]<0)
+        {
+            for(unsigned i=0;i<r;i++) ::kill(pid[i],SIGKILL);
+            for(unsigned i=0;i<r;i++) ::waitpid(pid[i],nullptr,0);
+            close_all();
+            throw std::runtime_error("не удалось запустить узел");
+        }
+    }
+    for(auto &row : mesh) for(int &fd : row) if(fd>=0) { ::close(fd); fd=-1; }
+    for(int &fd : child) { ::close(fd); fd=-1; }
+
+    DistributedStats res;
+    res.shards.resize(n);
+    std::string err;
+    for(unsigned r=0;r<n;r++)
+    {
+        try {
+            char status;
+            recv_all(ctl[r],&status,1);
+            if(status)
+            {
+                std::uint32_t len;
+                recv_all(ctl[r],&len,sizeof(len));
+                std::string msg(len,'\0');
+                recv_all(ctl[r],&msg[0],len);
+                throw std::runtime_error(msg);
+            }
+            recv_all(ctl[r],&res.shards[r],sizeof(ShardStats));
+            if(gather)
+            {
+                std::vector<int> part;
+                recv_ints(ctl[r],part);
+                gather->insert(gather->end(),part.begin(),part.end());
+            }
+            res.elements+=res.shards[r].output;
+        }
+        catch(const std::exception &e) {
+            if(err.empty()) err="узел "+std::to_string(r)+": "+e.what();
+        }
+    }
+    for(unsigned r=0;r<n;r++)
+    {
+        int status=0;
+        ::waitpid(pid[r],&status,0);
+        if(err.empty() && !(WIFEXITED(status) && WEXITSTATUS(status)==0))
+            err="узел "+std::to_string(r)+" завершился аварийно";
+    }
+    close_all();
+    if(!err.empty()) throw std::runtime_error(err);
+    return res;
+}
+
+std::string shard_name(const std::string &out, unsigned r)
+{
+    if(is_binary_name(out)) return out.substr(0,out.size()-4)+"."+std::to_string(r)+".bin";
+    return out+"."+std::to_string(r);
+}
+
+void write_shard(const std::string &path, const std::vector<int> &v)
+{
+    int fd=::open(path.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if(fd<0) throw std::runtime_error("не удалось открыть "+path);
+    try {
+        if(is_binary_name(path)) send_all(fd,v.data(),v.size()*sizeof(int));
+        else
+        {
+            std::vector<char> buf;
+            buf.reserve(std::size_t(1)<<20);
+            char tmp[12];
+            for(std::size_t i=0;i<v.size();i++)
+            {
+                int x=v[i], k=0;
+                unsigned u=x<0 ? 0u-(unsigned)x : (unsigned)x;
+                do { tmp[k++]=char('0'+u%10); u/=10; } while(u);
+                if(x<0) buf.push_back('-');
+                while(k) buf.push_back(tmp[--k]);
+                buf.push_back('\n');
+                if(buf.size()+16>=buf.capacity() || i+1==v.size())
+                {
+                    send_all(fd,buf.data(),buf.size());
+                    buf.clear();
+                }
+            }
+        }
+    }
+    catch(const std::exception&) {
+        ::close(fd);
+        throw std::runtime_error("ошибка записи в "+path);
+    }
+    if(::close(fd)!=0) throw std::runtime_error("ошибка записи в "+path);
+}
+
+}
+
+DistributedStats distributed_sort(std::vector<int> &v, const DistributedOptions &opt)
+{
+    const unsigned n=std::max(1u,opt.workers);
+    //узлы получают v при fork и берут из него только свою долю
+    auto load=[&](unsigned r) {
+        return std::vector<int>(v.begin()+v.size()*r/n,v.begin()+v.size()*(r+1)/n);
+    };
+    std::vector<int> res;
+    res.reserve(v.size());
+    DistributedStats st=launch(opt,load,nullptr,&res);
+    v.swap(res);
+    return st;
+}
+
+DistributedStats distributed_sort(const std::string &in, const std::string &out, const DistributedOptions &opt)
+{
+    const unsigned n=std::max(1u,opt.workers);
+    //файл открывается заранее, чтобы ошибка была у вызывающего, а не у узлов
+    IntFile f(in);
+    auto load=[&](unsigned r) {
+        if(f.binary()) return std::vector<int>(f.data()+f.count()*r/n,f.data()+f.count()*(r+1)/n);
+        //границы как в parse_ints: до ближайшего разделителя, число не режется
+        const char *begin=f.bytes(), *end=begin+f.size();
+        auto cut=[&](unsigned k) {
+            const char *c=begin+f.size()*k/n;
+            while(c<end && (*c=='-' || detail::is_digit(*c))) c++;
+            return c;
+        };
+        return parse_ints(r ? cut(r) : begin,cut(r+1),opt.threads);
+    };
+    auto store=[&](unsigned r, const std::vector<int> &v) { write_shard(shard_name(out,r),v); };
+    DistributedStats st=launch(opt,load,store,nullptr);
+    for(unsigned r=0;r<n;r++) st.files.push_back(shard_name(out,r));
+    return st;
+}
+
+}
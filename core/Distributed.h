@@ -0,0 +1,59 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_DISTRIBUTED_H
+#define SORT_DISTRIBUTED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sortcore {
+
+struct DistributedOptions{
+    unsigned workers=4; //процессов-узлов, каждый владеет своей долей
+    unsigned threads=1; //потоков сортировки внутри узла, 0 -- по числу ядер
+    unsigned oversampling=32; //элементов выборки с узла на каждый узел
+};
+
+//Статистика одного узла
+struct ShardStats{
+    std::uint64_t input=0; //элементов в исходной доле
+    std::uint64_t output=0; //в отсортированной доле после обмена
+    std::uint64_t sent=0; //отдано другим узлам
+    std::uint64_t received=0; //получено от других узлов
+    double sort_ms=0, exchange_ms=0, merge_ms=0;
+};
+
+struct DistributedStats{
+    std::vector<ShardStats> shards;
+    std::vector<std::string> files; //доли результата для файловой сортировки
+    std::uint64_t elements=0;
+    //Отношение самой большой доли к средней; 1 -- идеальное разбиение
+    double imbalance() const;
+};
+
+//Распределённая сортировка выборкой на локальных процессах вместо машин.
+//Каждый из workers процессов берёт свою долю, сортирует её (sample_sort),
+//отправляет остальным регулярную выборку и по общей выборке с весами долей
+//находит те же разделители, что и все. Ключ дополнен номером узла и
+//позицией, поэтому равные элементы тоже делятся поровну. Затем обмен
+//"все со всеми" по UNIX-сокетам и слияние полученных кусков деревом
+//проигравших. Процессы создаются через fork, поэтому вызывать из процесса,
+//где ещё не запущены другие потоки. Только POSIX; ошибки -- std::runtime_error.
+
+//v делится на равные доли, результат собирается обратно в v
+DistributedStats distributed_sort(std::vector<int> &v, const DistributedOptions &opt=DistributedOptions());
+
+//Файл целых (текст или .bin) делится на доли по байтам, каждый узел читает
+//свою часть через отображение и пишет свою отсортированную долю в отдельный
+//файл: out.<узел> или, для .bin, <имя>.<узел>.bin. Доли по порядку номеров
+//образуют отсортированную последовательность.
+DistributedStats distributed_sort(const std::string &in, const std::string &out,
+                                  const DistributedOptions &opt=DistributedOptions());
+
+}
+
+#endif //SORT_DISTRIBUTED_H
@@ -0,0 +1,260 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "External.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "LoserTree.h"
+#include "ParallelQuick.h"
+#include "Ingest.h"
+#include <sys/resource.h>
+
+namespace sortcore {
+
+namespace {
+
+//Меньше этого буфер одного источника при слиянии не делается
+const std::size_t min_merge_buffer=std::size_t(1)<<16;
+//а больше этого уже не ускоряет последовательный ввод-вывод
+const std::size_t max_merge_buffer=std::size_t(4)<<20;
+//Буфер чтения текста: 1/16 бюджета, но не больше мегабайта
+const std::size_t max_text_buffer=std::size_t(1)<<20;
+//Дескрипторы, оставляемые стандартным потокам, входу и остальной программе
+const std::size_t reserved_files=16;
+
+//Все сливаемые куски открыты одновременно, плюс выходной: их число ограничено
+//не только бюджетом, но и лимитом открытых файлов процесса
+std::size_t merge_fanin(std::size_t memory)
+{
+    std::size_t fanin=std::max<std::size_t>(3,memory/min_merge_buffer)-1;
+    rlimit rl;
+    if(getrlimit(RLIMIT_NOFILE,&rl)==0 && rl.rlim_cur!=RLIM_INFINITY)
+        fanin=std::min<std::size_t>(fanin,std::max<std::size_t>(2,(std::size_t)rl.rlim_cur-std::min<std::size_t>(rl.rlim_cur,reserved_files+1)));
+    return fanin;
+}
+
+struct FileCloser{
+    void operator()(std::FILE *f) const { if(f) std::fclose(f); }
+};
+typedef std::unique_ptr<std::FILE,FileCloser> File;
+
+File open(const std::string &name, const char *mode)
+{
+    File f(std::fopen(name.c_str(),mode));
+    if(!f) throw std::runtime_error("не удалось открыть "+name);
+    return f;
+}
+
+//Временный файл для отсортированного куска, удаляется при закрытии
+File temporary()
+{
+    File f(std::tmpfile());
+    if(!f) throw std::runtime_error("не удалось создать временный файл");
+    return f;
+}
+
+//Поток целых из текста: читает крупными блоками, число на стыке блоков
+//переносится в начало следующего
+class TextReader{
+    std::FILE *f;
+    std::vector<char> buf;
+    std::size_t pos=0, len=0;
+    bool eof=false;
+    std::uint64_t consumed=0;
+    void refill() {
+        std::copy(buf.begin()+pos,buf.begin()+len,buf.begin());
+        len-=pos;
+        consumed+=pos;
+        pos=0;
+        std::size_t got=std::fread(buf.data()+len,1,buf.size()-len,f);
+        if(got==0) eof=true;
+        len+=got;
+    }
+public:
+    TextReader(std::FILE *f, std::size_t bytes) : f(f), buf(std::max<std::size_t>(bytes,64)) {}
+    std::uint64_t bytes() const { return consumed+pos; }
+    bool next(int &x) {
+        for(;;)
+        {
+            //самое длинное число с минусом -- 20 символов
+            if(len-pos<24 && !eof) refill();
+            while(pos<len && buf[pos]!='-' && (buf[pos]<'0' || buf[pos]>'9')) pos++;
+            if(pos<len) break;
+            if(eof) return false;
+        }
+        if(len-pos<24 && !eof) refill();
+        const char *p=buf.data()+pos;
+        if(!parse_int(p,buf.data()+len,x)) return false;
+        pos=p-buf.data();
+        return true;
+    }
+};
+
+//Чтение куска из временного файла блоками
+class RunReader{
+    std::FILE *f;
+    std::vector<int> buf;
+    std::size_t pos=0, len=0;
+public:
+    RunReader(std::FILE *f, std::size_t elems) : f(f), buf(elems) {
+        std::rewind(f);
+        fill();
+    }
+    void fill() {
+        len=std::fread(buf.data(),sizeof(int),buf.size(),f);
+        pos=0;
+    }
+    bool empty() const { return pos>=len; }
+    int head() const { return buf[pos]; }
+    void pop() { if(++pos==len) fill(); }
+};
+
+class BinaryWriter{
+    std::FILE *f;
+    std::vector<int> buf;
+    std::size_t len=0;
+public:
+    BinaryWriter(std::FILE *f, std::size_t elems) : f(f), buf(elems) {}
+    void put(int x) {
+        buf[len++]=x;
+        if(len==buf.size()) flush();
+    }
+    void flush() {
+        if(len && std::fwrite(buf.data(),sizeof(int),len,f)!=len) throw std::runtime_error("ошибка записи");
+        len=0;
+    }
+};
+
+class TextWriter{
+    std::FILE *f;
+    std::vector<char> buf;
+    std::size_t len=0;
+public:
+    TextWriter(std::FILE *f, std::size_t bytes) : f(f), buf(std::max<std::size_t>(bytes,64)) {}
+    void put(int x) {
+        if(buf.size()-len<16) flush();
+        char tmp[12];
+        int n=0;
+        unsigned u=x<0 ? 0u-(unsigned)x : (unsigned)x;
+        do { tmp[n++]=char('0'+u%10); u/=10; } while(u);
+        if(x<0) buf[len++]='-';
+        while(n) buf[len++]=tmp[--n];
+        buf[len++]='\n';
+    }
+    void flush() {
+        if(len && std::fwrite(buf.data(),1,len,f)!=len) throw std::runtime_error("ошибка записи");
+        len=0;
+    }
+};
+
+//Слияние кусков src в out; done/total -- для отчёта о ходе работы
+template<class Writer>
+void merge(std::vector<File> &src, Writer &out, std::size_t elems, std::uint64_t &done, std::uint64_t total,
+           const ExternalOptions &opt)
+{
+    std::vector<RunReader> r;
+    r.reserve(src.size());
+    for(auto &f : src) r.emplace_back(f.get(),elems);
+    auto less=[&r](std::ptrdiff_t a, std::ptrdiff_t b) {
+        if(r[b].empty()) return !r[a].empty();
+        return !r[a].empty() && r[a].head()<r[b].head();
+    };
+    LoserTree<decltype(less)> lt((std::ptrdiff_t)r.size(),less);
+    for(;;)
+    {
+        std::ptrdiff_t w=lt.winner();
+        if(r[w].empty()) break;
+        out.put(r[w].head());
+        r[w].pop();
+        lt.replay(w);
+        if(opt.progress && (++done&0xfffff)==0) opt.progress((double)done/total);
+    }
+    out.flush();
+}
+
+}
+
+ExternalStats external_sort(const std::string &in, const std::string &out, const ExternalOptions &opt)
+{
+    ExternalStats st;
+    File fin=open(in,"rb");
+    std::fseek(fin.get(),0,SEEK_END);
+    double size=(double)std::max<long>(1,std::ftell(fin.get()));
+    std::rewind(fin.get());
+    //первый проход: куски по бюджету памяти, каждый сортируется всеми потоками
+    std::vector<File> runs;
+    {
+        bool bin=is_binary_name(in);
+        std::size_t tb=bin ? 0 : std::min(max_text_buffer,opt.memory/16);
+        TextReader rd(fin.get(),tb);
+        //в тексте на число уходит хотя бы два байта: цифра и разделитель
+        std::size_t cap=std::min((opt.memory-tb)/sizeof(int),(std::size_t)size/(bin ? sizeof(int) : 2)+1);
+        std::vector<int> chunk(std::max<std::size_t>(1,cap));
+        for(;;)
+        {
+            std::size_t n=0;
+            if(bin) n=std::fread(chunk.data(),sizeof(int),chunk.size(),fin.get());
+            else while(n<chunk.size() && rd.next(chunk[n])) n++;
+            if(n==0) break;
+            parallel_quick_sort(chunk.begin(),chunk.begin()+n,std::less<>(),opt.threads);
+            runs.push_back(temporary());
+            if(std::fwrite(chunk.data(),sizeof(int),n,runs.back().get())!=n) throw std::runtime_error("ошибка записи");
+            st.elements+=n;
+            //первый проход считаем половиной работы
+            if(opt.progress) opt.progress(0.5*(bin ? (double)std::ftell(fin.get()) : (double)rd.bytes())/size);
+            if(n<chunk.size()) break;
+        }
+    }
+    fin.reset();
+    st.runs=runs.size();
+    //сколько кусков можно сливать за раз, чтобы буферы уместились в бюджет
+    std::size_t fanin=merge_fanin(opt.memory);
+    unsigned passes=1;
+    for(std::size_t k=runs.size();k>fanin;k=(k+fanin-1)/fanin) passes++;
+    std::uint64_t done=0, total=std::max<std::uint64_t>(1,st.elements*passes);
+    auto report=[&](double x) { if(opt.progress) opt.progress(0.5+0.5*x); };
+    ExternalOptions inner=opt;
+    inner.progress=report;
+    while(runs.size()>fanin)
+    {
+        std::vector<File> next;
+        std::size_t elems=std::min(max_merge_buffer,opt.memory/(fanin+1))/sizeof(int);
+        for(std::size_t i=0;i<runs.size();i+=fanin)
+        {
+            std::vector<File> group;
+            for(std::size_t j=i;j<std::min(runs.size(),i+fanin);j++) group.push_back(std::move(runs[j]));
+            next.push_back(temporary());
+            BinaryWriter w(next.back().get(),elems);
+            merge(group,w,elems,done,total,inner);
+        }
+        runs=std::move(next);
+        st.passes++;
+    }
+    File fout=open(out,"wb");
+    if(runs.empty())
+    {
+        if(opt.progress) opt.progress(1.0);
+        return st;
+    }
+    std::size_t elems=std::max(min_merge_buffer,std::min(max_merge_buffer,opt.memory/(runs.size()+1)))/sizeof(int);
+    if(is_binary_name(out))
+    {
+        BinaryWriter w(fout.get(),elems);
+        merge(runs,w,elems,done,total,inner);
+    }
+    else
+    {
+        TextWriter w(fout.get(),elems*sizeof(int));
+        merge(runs,w,elems,done,total,inner);
+    }
+    st.passes++;
+    if(std::fflush(fout.get())!=0) throw std::runtime_error("ошибка записи в "+out);
+    if(opt.progress) opt.progress(1.0);
+    return st;
+}
+
+}
@@ -0,0 +1,40 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_EXTERNAL_H
+#define SORT_EXTERNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace sortcore {
+
+struct ExternalOptions{
+    std::size_t memory=std::size_t(256)<<20; //бюджет памяти, байт
+    unsigned threads=0; //потоки для сортировки кусков, 0 -- по числу ядер
+    //доля выполненной работы от 0 до 1; вызывается из вызывающего потока
+    std::function<void(double)> progress;
+};
+
+struct ExternalStats{
+    std::uint64_t elements=0;
+    std::size_t runs=0; //отсортированных кусков после первого прохода
+    unsigned passes=0; //проходов слияния
+};
+
+//Внешняя сортировка текстового файла целых чисел (любые пробельные
+//разделители) в out, по числу на строку. Файлы с расширением .bin читаются и
+//пишутся в двоичном формате IntFile. Файл читается кусками по бюджету
+//памяти, куски сортируются параллельно и сбрасываются во временные файлы,
+//затем сливаются дерево проигравших с крупными последовательными буферами.
+//Если кусков больше, чем помещается буферов в бюджет, слияние многопроходное.
+//Ошибки ввода-вывода -- std::runtime_error.
+ExternalStats external_sort(const std::string &in, const std::string &out,
+                            const ExternalOptions &opt=ExternalOptions());
+
+}
+
+#endif //SORT_EXTERNAL_H
@@ -0,0 +1,105 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Generator.h"
+#include <algorithm>
+#include <cmath>
+#include "Parallel.h"
+
+namespace sortcore {
+
+namespace {
+
+const std::size_t generate_grain=std::size_t(1)<<16;
+
+//Равномерное в [0, range) без деления: старшие 64 бита произведения
+int uniform(std::uint64_t r, std::uint64_t range)
+{
+    return int((unsigned __int128)r*range>>64);
+}
+
+//[0, 1) из старших 53 бит
+double unit(std::uint64_t r)
+{
+    return (r>>11)*(1.0/9007199254740992.0);
+}
+
+}
+
+const char *name(Distribution d)
+{
+    switch(d)
+    {
+        case Distribution::Uniform: return "Равномерное";
+        case Distribution::Sorted: return "Упорядоченное";
+        case Distribution::Reverse: return "Обратное";
+        case Distribution::FewUnique: return "Мало различных";
+        case Distribution::OrganPipe: return "Органные трубы";
+        case Distribution::Sawtooth: return "Пила";
+        case Distribution::Zipf: return "Ципф";
+        case Distribution::AlmostSorted: return "Почти упорядоченное";
+    }
+    return "";
+}
+
+const char *id(Distribution d)
+{
+    switch(d)
+    {
+        case Distribution::Uniform: return "uniform";
+        case Distribution::Sorted: return "sorted";
+        case Distribution::Reverse: return "reverse";
+        case Distribution::FewUnique: return "few_unique";
+        case Distribution::OrganPipe: return "organ_pipe";
+        case Distribution::Sawtooth: return "sawtooth";
+        case Distribution::Zipf: return "zipf";
+        case Distribution::AlmostSorted: return "almost_sorted";
+    }
+    return "";
+}
+
+void generate(int *out, std::size_t n, const GeneratorOptions &opt)
+{
+    if(n==0) return;
+    const std::uint64_t range=opt.range>0 ? (std::uint64_t)opt.range : std::max<std::uint64_t>(1,std::min<std::uint64_t>(n,0x7fffffff));
+    const std::uint64_t unique=std::max(1u,opt.unique), tooth=std::max<std::uint64_t>(1,n/std::max(1u,opt.teeth));
+    //Ципф через обратную функцию непрерывного приближения: ранг r с
+    //вероятностью ~ 1/r^s, ранги 1..range
+    const double s=opt.zipf, lnN=std::log((double)range), a=std::pow((double)range,1-s)-1;
+    auto zipf=[&](std::uint64_t r) {
+        double u=unit(r), x=std::fabs(s-1)<1e-9 ? std::exp(u*lnN) : std::pow(a*u+1,1/(1-s));
+        return int(std::min<double>((double)range,std::max(1.0,std::floor(x))))-1;
+    };
+    auto at=[&](std::uint64_t i) {
+        std::uint64_t r=counter_random(opt.seed,i);
+        switch(opt.dist)
+        {
+            case Distribution::Uniform: return uniform(r,range);
+            case Distribution::Sorted: return int(i*range/n);
+            case Distribution::Reverse: return int((n-1-i)*range/n);
+            case Distribution::FewUnique: return int((std::uint64_t)uniform(r,unique)*range/unique);
+            case Distribution::OrganPipe: return int((i<n/2 ? i : n-1-i)*2*range/std::max<std::uint64_t>(2,n));
+            case Distribution::Sawtooth: return int(i%tooth*range/tooth);
+            case Distribution::Zipf: return zipf(r);
+            case Distribution::AlmostSorted:
+                //отдельная случайная величина решает, сдвинут ли элемент
+                if(unit(counter_random(~opt.seed,i))<opt.noise) return uniform(r,range);
+                return int(i*range/n);
+        }
+        return 0;
+    };
+    unsigned p=(unsigned)std::max<std::size_t>(1,std::min<std::size_t>(threads_or_default(opt.threads),n/generate_grain));
+    detail::fork_join(p,[&](unsigned t) {
+        for(std::size_t i=n*t/p;i<n*(t+1)/p;i++) out[i]=at(i);
+    });
+}
+
+std::vector<int> generate(std::size_t n, const GeneratorOptions &opt)
+{
+    std::vector<int> v(n);
+    generate(v.data(),n,opt);
+    return v;
+}
+
+}
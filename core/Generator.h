@@ -0,0 +1,50 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_GENERATOR_H
+#define SORT_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sortcore {
+
+enum class Distribution{Uniform, Sorted, Reverse, FewUnique, OrganPipe, Sawtooth, Zipf, AlmostSorted};
+
+const Distribution distributions[]={Distribution::Uniform, Distribution::Sorted, Distribution::Reverse,
+                                    Distribution::FewUnique, Distribution::OrganPipe, Distribution::Sawtooth,
+                                    Distribution::Zipf, Distribution::AlmostSorted};
+
+const char *name(Distribution d);
+const char *id(Distribution d);
+
+struct GeneratorOptions{
+    Distribution dist=Distribution::Uniform;
+    std::uint64_t seed=1;
+    int range=0; //значения в [0, range), 0 -- по длине массива
+    unsigned unique=16; //FewUnique: число различных значений
+    unsigned teeth=8; //Sawtooth: число зубцов
+    double zipf=1.0; //Zipf: показатель s
+    double noise=0.01; //AlmostSorted: доля элементов не на своём месте
+    unsigned threads=0;
+};
+
+//Счётчиковый генератор SplitMix64: i-е число -- перемешивание seed + i*gamma,
+//поэтому любой кусок массива считается независимо, а результат не зависит
+//от числа потоков и воспроизводится по seed
+inline std::uint64_t counter_random(std::uint64_t seed, std::uint64_t i)
+{
+    std::uint64_t z=seed+(i+1)*0x9E3779B97F4A7C15ull;
+    z=(z^(z>>30))*0xBF58476D1CE4E5B9ull;
+    z=(z^(z>>27))*0x94D049BB133111EBull;
+    return z^(z>>31);
+}
+
+void generate(int *out, std::size_t n, const GeneratorOptions &opt=GeneratorOptions());
+std::vector<int> generate(std::size_t n, const GeneratorOptions &opt=GeneratorOptions());
+
+}
+
+#endif //SORT_GENERATOR_H
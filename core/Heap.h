@@ -0,0 +1,252 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_HEAP_H
+#define SORT_HEAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "Trace.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Просеивание вниз в max-куче a[lo..lo+n) через "дырку": элементы сдвигаются
+//записями, а не обменами; root и потомки -- номера внутри кучи
+template<class RandomIt, class Compare, class Trace>
+void sift_down(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t root, std::ptrdiff_t n, Compare &comp, Trace &tr)
+{
+    auto v=std::move(a[lo+root]);
+    std::ptrdiff_t hole=root;
+    for(;;)
+    {
+        std::ptrdiff_t child=2*hole+1;
+        if(child>=n) break;
+        if(child+1<n)
+        {
+            tr.compare(lo+child,lo+child+1);
+            if(comp(a[lo+child],a[lo+child+1])) ++child;
+        }
+        tr.compare(lo+root,lo+child);
+        if(!comp(v,a[lo+child])) break;
+        a[lo+hole]=std::move(a[lo+child]);
+        tr.write(lo+hole,a[lo+hole]);
+        hole=child;
+    }
+    a[lo+hole]=std::move(v);
+    if(hole!=root) tr.write(lo+hole,a[lo+hole]);
+}
+
+//Подсказка процессору загрузить a[i] в кэш заранее; i за пределами кучи не трогаем
+template<class RandomIt>
+inline void prefetch(RandomIt a, std::ptrdiff_t i, std::ptrdiff_t end)
+{
+#if defined(__GNUC__)
+    if(i<end) __builtin_prefetch(&a[i]);
+#else
+    (void)a; (void)i; (void)end;
+#endif
+}
+
+//Просеивание "снизу вверх" (Вегенер): дырка спускается до листа по большему
+//потомку -- одно сравнение на уровень вместо двух, -- а затем v поднимается
+//от листа на своё место. Просеиваемый элемент обычно оказывается почти внизу,
+//поэтому подъём короткий. Пока спускаемся, подгружаем потомков на четыре
+//уровня ниже (16*hole+15..16*hole+30): потомок выбирается без ветвления, и
+//процессор сам вперёд не заглядывает, а внуки -- всего два шага, этого мало,
+//чтобы дождаться памяти. 16 соседних элементов -- две подгрузки.
+template<class RandomIt, class Compare, class Trace>
+void sift_bottom_up(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t root, std::ptrdiff_t n, Compare &comp, Trace &tr)
+{
+    auto v=std::move(a[lo+root]);
+    std::ptrdiff_t hole=root;
+    while(2*hole+2<n)
+    {
+        std::ptrdiff_t child=2*hole+1;
+        //потомки на четыре уровня ниже -- 16 соседних элементов
+        std::ptrdiff_t deep=16*hole+15;
+        prefetch(a,lo+deep,lo+n);
+        prefetch(a,lo+deep+15,lo+n);
+        tr.compare(lo+child,lo+child+1);
+        child+=comp(a[lo+child],a[lo+child+1]); //без ветвления: исход случаен
+        a[lo+hole]=std::move(a[lo+child]);
+        tr.write(lo+hole,a[lo+hole]);
+        hole=child;
+    }
+    if(2*hole+1<n)
+    {
+        a[lo+hole]=std::move(a[lo+2*hole+1]);
+        tr.write(lo+hole,a[lo+hole]);
+        hole=2*hole+1;
+    }
+    while(hole>root)
+    {
+        std::ptrdiff_t parent=(hole-1)/2;
+        tr.compare(lo+parent,lo+hole);
+        if(!comp(a[lo+parent],v)) break;
+        a[lo+hole]=std::move(a[lo+parent]);
+        tr.write(lo+hole,a[lo+hole]);
+        hole=parent;
+    }
+    a[lo+hole]=std::move(v);
+    tr.write(lo+hole,a[lo+hole]);
+}
+
+//Арность кучи для heap4: четыре потомка int лежат в 16 байтах, четверть
+//строки кэша. Шестнадцать внуков занимают 64 байта, но начинаются с 16i+5,
+//а куча строится на месте в чужом массиве, выравнивания которого мы не
+//выбираем, -- поэтому они обычно задевают две строки, и подгружаются обе.
+const std::ptrdiff_t heap_arity=4;
+
+//Просеивание снизу вверх в 4-арной max-куче: потомки i -- 4i+1..4i+4.
+//Уровней вдвое меньше, чем в двоичной, а потомки узла соседствуют в памяти,
+//так что на уровень приходится один промах кэша вместо двух.
+template<class RandomIt, class Compare, class Trace>
+void sift_down4(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t root, std::ptrdiff_t n, Compare &comp, Trace &tr)
+{
+    auto v=std::move(a[lo+root]);
+    std::ptrdiff_t hole=root;
+    for(;;)
+    {
+        std::ptrdiff_t child=heap_arity*hole+1;
+        if(child>=n) break;
+        std::ptrdiff_t grand=heap_arity*child+1;
+        prefetch(a,lo+grand,lo+n);
+        prefetch(a,lo+grand+heap_arity*heap_arity-1,lo+n);
+        std::ptrdiff_t best=child;
+        if(child+heap_arity<=n)
+        {
+            //турнир: две независимые пары, затем победители
+            tr.compare(lo+child,lo+child+1);
+            tr.compare(lo+child+2,lo+child+3);
+            std::ptrdiff_t x=child+comp(a[lo+child],a[lo+child+1]);
+            std::ptrdiff_t y=child+2+comp(a[lo+child+2],a[lo+child+3]);
+            tr.compare(lo+x,lo+y);
+            best=comp(a[lo+x],a[lo+y]) ? y : x;
+        }
+        else
+            for(std::ptrdiff_t k=child+1;k<n;k++)
+            {
+                tr.compare(lo+best,lo+k);
+                if(comp(a[lo+best],a[lo+k])) best=k;
+            }
+        a[lo+hole]=std::move(a[lo+best]);
+        tr.write(lo+hole,a[lo+hole]);
+        hole=best;
+    }
+    while(hole>root)
+    {
+        std::ptrdiff_t parent=(hole-1)/heap_arity;
+        tr.compare(lo+parent,lo+hole);
+        if(!comp(a[lo+parent],v)) break;
+        a[lo+hole]=std::move(a[lo+parent]);
+        tr.write(lo+hole,a[lo+hole]);
+        hole=parent;
+    }
+    a[lo+hole]=std::move(v);
+    tr.write(lo+hole,a[lo+hole]);
+}
+
+//Пирамидальная сортировка a[lo..hi); Sift -- одно из просеиваний выше,
+//Arity -- соответствующая ему арность кучи
+template<std::ptrdiff_t Arity, class Sift, class RandomIt, class Compare, class Trace>
+void heap_with(Sift sift, RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    std::ptrdiff_t n=hi-lo;
+    for(std::ptrdiff_t i=(n-2)/Arity;n>1 && i>=0;i--)
+        sift(a,lo,i,n,comp,tr);
+    for(std::ptrdiff_t end=n-1;end>0;end--)
+    {
+        using std::swap;
+        swap(a[lo],a[lo+end]);
+        tr.swap(lo,lo+end);
+        sift(a,lo,0,end,comp,tr);
+    }
+}
+
+template<class RandomIt, class Compare, class Trace>
+void heap(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    heap_with<2>(sift_down<RandomIt,Compare,Trace>,a,lo,hi,comp,tr);
+}
+
+template<class RandomIt, class Compare, class Trace>
+void heap_bottom_up(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    heap_with<2>(sift_bottom_up<RandomIt,Compare,Trace>,a,lo,hi,comp,tr);
+}
+
+template<class RandomIt, class Compare, class Trace>
+void heap4(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    heap_with<heap_arity>(sift_down4<RandomIt,Compare,Trace>,a,lo,hi,comp,tr);
+}
+
+}
+
+template<class RandomIt, class Compare, class Trace>
+void heap_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    detail::heap(first,0,last-first,comp,tr);
+}
+
+//Двоичная куча с просеиванием снизу вверх: ~n log n сравнений вместо ~2n log n
+template<class RandomIt, class Compare, class Trace>
+void bottom_up_heap_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    detail::heap_bottom_up(first,0,last-first,comp,tr);
+}
+
+template<class RandomIt, class Compare>
+void bottom_up_heap_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    bottom_up_heap_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void bottom_up_heap_sort(RandomIt first, RandomIt last)
+{
+    bottom_up_heap_sort(first,last,std::less<>());
+}
+
+//4-арная куча с подгрузкой внуков: вдвое меньше промахов кэша на больших массивах
+template<class RandomIt, class Compare, class Trace>
+void heap4_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    detail::heap4(first,0,last-first,comp,tr);
+}
+
+template<class RandomIt, class Compare>
+void heap4_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    heap4_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void heap4_sort(RandomIt first, RandomIt last)
+{
+    heap4_sort(first,last,std::less<>());
+}
+
+template<class RandomIt, class Compare>
+void heap_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    heap_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void heap_sort(RandomIt first, RandomIt last)
+{
+    heap_sort(first,last,std::less<>());
+}
+
+}
+
+#endif //SORT_HEAP_H
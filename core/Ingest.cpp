@@ -0,0 +1,102 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Ingest.h"
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Parallel.h"
+
+namespace sortcore {
+
+namespace {
+
+//Меньше этого объёма текста на поток разбор не распараллеливается
+const std::size_t parse_grain=std::size_t(1)<<20;
+
+bool separator(char c) { return c!='-' && !detail::is_digit(c); }
+
+}
+
+std::vector<int> parse_ints(const char *begin, const char *end, unsigned threads)
+{
+    std::size_t n=end-begin;
+    unsigned p=(unsigned)std::max<std::size_t>(1,std::min<std::size_t>(threads_or_default(threads),n/parse_grain));
+    //границы кусков сдвигаются до разделителя, чтобы не разрезать число
+    std::vector<const char*> cut(p+1);
+    cut[0]=begin;
+    cut[p]=end;
+    for(unsigned t=1;t<p;t++)
+    {
+        const char *c=std::max(cut[t-1],begin+n*t/p);
+        while(c<end && !separator(*c)) c++;
+        cut[t]=c;
+    }
+    std::vector<std::vector<int>> part(p);
+    detail::fork_join(p,[&](unsigned t) {
+        std::vector<int> &out=part[t];
+        //в тексте на число уходит хотя бы два байта
+        out.reserve((cut[t+1]-cut[t])/2+1);
+        const char *s=cut[t];
+        int x;
+        while(parse_int(s,cut[t+1],x)) out.push_back(x);
+    });
+    if(p==1) return std::move(part[0]);
+    std::vector<std::size_t> off(p+1,0);
+    for(unsigned t=0;t<p;t++) off[t+1]=off[t]+part[t].size();
+    std::vector<int> res(off[p]);
+    detail::fork_join(p,[&](unsigned t) { std::copy(part[t].begin(),part[t].end(),res.begin()+off[t]); });
+    return res;
+}
+
+IntFile::IntFile(const std::string &path) : bin(is_binary_name(path))
+{
+    int fd=::open(path.c_str(),O_RDONLY);
+    if(fd<0) throw std::runtime_error("не удалось открыть "+path);
+    struct stat st;
+    if(::fstat(fd,&st)!=0)
+    {
+        ::close(fd);
+        throw std::runtime_error("не удалось открыть "+path);
+    }
+    len=(std::size_t)st.st_size;
+    if(len)
+    {
+        void *m=::mmap(nullptr,len,PROT_READ,MAP_PRIVATE,fd,0);
+        if(m==MAP_FAILED)
+        {
+            ::close(fd);
+            throw std::runtime_error("не удалось отобразить "+path);
+        }
+        ::madvise(m,len,MADV_SEQUENTIAL);
+        base=static_cast<const char*>(m);
+    }
+    ::close(fd);
+}
+
+IntFile::~IntFile()
+{
+    if(base) ::munmap(const_cast<char*>(base),len);
+}
+
+std::vector<int> IntFile::values(unsigned threads) const
+{
+    if(bin) return std::vector<int>(data(),data()+count());
+    return parse_ints(base,base+len,threads);
+}
+
+bool is_binary_name(const std::string &path)
+{
+    return path.size()>=4 && path.compare(path.size()-4,4,".bin")==0;
+}
+
+std::vector<int> read_ints(const std::string &path, unsigned threads)
+{
+    return IntFile(path).values(threads);
+}
+
+}
@@ -0,0 +1,113 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_INGEST_H
+#define SORT_INGEST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__!=__ORDER_LITTLE_ENDIAN__
+#error "parse_int and the .bin format assume a little-endian host"
+#endif
+
+namespace sortcore {
+
+namespace detail {
+
+inline bool is_digit(char c) { return c>='0' && c<='9'; }
+
+//Число подряд идущих цифр в 8 байтах (младший байт -- первый символ).
+//Перенос из байта >= 0xFA портит только байты после первой не-цифры.
+inline unsigned digit_run(std::uint64_t chunk)
+{
+    std::uint64_t t=((chunk&0xF0F0F0F0F0F0F0F0ull) | (((chunk+0x0606060606060606ull)&0xF0F0F0F0F0F0F0F0ull)>>4))
+                    ^0x3333333333333333ull;
+    return t ? unsigned(__builtin_ctzll(t))/8 : 8;
+}
+
+//Значение len<=8 цифр из 8 байт: три умножения вместо len
+inline std::uint32_t eight_digits(std::uint64_t chunk, unsigned len)
+{
+    std::uint64_t v=chunk-0x3030303030303030ull;
+    v<<=8*(8-len);
+    v=v*10+(v>>8);
+    v=(((v&0x000000FF000000FFull)*0x000F424000000064ull)+(((v>>16)&0x000000FF000000FFull)*0x0000271000000001ull))>>32;
+    return std::uint32_t(v);
+}
+
+}
+
+//Разбирает следующее целое из [p, end), пропуская разделители (всё, кроме
+//цифр и минуса перед цифрой). Пока до конца есть 8 байт, цифры берутся по
+//восемь за раз. Возвращает false, если чисел больше нет; p сдвигается за число.
+//Число вне диапазона int -- std::out_of_range (и из parse_ints, и из чтения
+//кусков внешней сортировки), а не молча искажённое значение.
+inline bool parse_int(const char *&p, const char *end, int &x)
+{
+    //модуль наименьшего int; больше него накопитель не растёт и не переполняется
+    const std::uint64_t limit=std::uint64_t(1)<<31;
+    static const std::uint64_t pow10[]={1,10,100,1000,10000,100000,1000000,10000000,100000000};
+    for(;;p++)
+    {
+        while(p<end && *p!='-' && !detail::is_digit(*p)) p++;
+        if(p==end) return false;
+        if(*p!='-' || (end-p>1 && detail::is_digit(p[1]))) break;
+    }
+    bool neg=*p=='-';
+    if(neg) p++;
+    std::uint64_t v=0;
+    while(end-p>=8)
+    {
+        std::uint64_t chunk;
+        std::memcpy(&chunk,p,8);
+        unsigned len=detail::digit_run(chunk);
+        if(len==0) break;
+        v=std::min(v*pow10[len]+detail::eight_digits(chunk,len),limit+1);
+        p+=len;
+        if(len<8) break;
+    }
+    while(p<end && detail::is_digit(*p)) v=std::min(v*10+std::uint64_t(*p++-'0'),limit+1);
+    if(v>(neg ? limit : limit-1)) throw std::out_of_range("число вне диапазона int");
+    x=neg ? int(-std::int64_t(v)) : int(v);
+    return true;
+}
+
+//Все целые из текста; threads потоков режут текст по разделителям
+std::vector<int> parse_ints(const char *begin, const char *end, unsigned threads=0);
+
+//Файл, отображённый в память. Двоичный формат (расширение .bin) -- сырые
+//int32 в порядке little-endian без заголовка; их можно читать прямо из
+//отображения через data() без копирования.
+class IntFile{
+    const char *base=nullptr;
+    std::size_t len=0;
+    bool bin;
+public:
+    explicit IntFile(const std::string &path);
+    ~IntFile();
+    IntFile(const IntFile&)=delete;
+    IntFile &operator=(const IntFile&)=delete;
+    bool binary() const { return bin; }
+    const char *bytes() const { return base; }
+    std::size_t size() const { return len; }
+    //Только для двоичного формата
+    const std::int32_t *data() const { return reinterpret_cast<const std::int32_t*>(base); }
+    std::size_t count() const { return len/sizeof(std::int32_t); }
+    std::vector<int> values(unsigned threads=0) const;
+};
+
+bool is_binary_name(const std::string &path);
+
+//Загрузка текстового или двоичного файла целых
+std::vector<int> read_ints(const std::string &path, unsigned threads=0);
+
+}
+
+#endif //SORT_INGEST_H
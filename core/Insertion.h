@@ -0,0 +1,61 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_INSERTION_H
+#define SORT_INSERTION_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "Trace.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Вставками на a[lo..hi); индексы для трассировки считаются от a
+template<class RandomIt, class Compare, class Trace>
+void insertion(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    for(std::ptrdiff_t i=lo+1;i<hi;i++)
+    {
+        auto v=std::move(a[i]);
+        std::ptrdiff_t j=i;
+        while(j>lo)
+        {
+            tr.compare(i,j-1);
+            if(!comp(v,a[j-1])) break;
+            a[j]=std::move(a[j-1]);
+            tr.write(j,a[j]);
+            --j;
+        }
+        a[j]=std::move(v);
+        if(j!=i) tr.write(j,a[j]);
+    }
+}
+
+}
+
+template<class RandomIt, class Compare, class Trace>
+void insertion_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    detail::insertion(first,0,last-first,comp,tr);
+}
+
+template<class RandomIt, class Compare>
+void insertion_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    insertion_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void insertion_sort(RandomIt first, RandomIt last)
+{
+    insertion_sort(first,last,std::less<>());
+}
+
+}
+
+#endif //SORT_INSERTION_H
@@ -0,0 +1,49 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_LOSERTREE_H
+#define SORT_LOSERTREE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace sortcore {
+
+//Дерево проигравших для k-путевого слияния: во внутренних узлах хранятся
+//проигравшие, в tree[0] -- победитель. Замена победителя стоит ровно log k
+//сравнений без ветвления на "левого/правого" потомка. less(i,j) сравнивает
+//текущие головы источников i и j; закончившиеся источники должны быть больше
+//всех. При равенстве побеждает меньший номер, поэтому слияние устойчиво.
+template<class Less>
+class LoserTree{
+    std::vector<std::ptrdiff_t> tree;
+    std::ptrdiff_t k;
+    Less less;
+    bool beats(std::ptrdiff_t a, std::ptrdiff_t b) {
+        if(less(a,b)) return true;
+        if(less(b,a)) return false;
+        return a<b;
+    }
+public:
+    LoserTree(std::ptrdiff_t k, Less less) : tree(k>0 ? k : 1,-1), k(k), less(less) {
+        for(std::ptrdiff_t i=0;i<k;i++) replay(i);
+    }
+    std::ptrdiff_t winner() const { return tree[0]; }
+    //Голова источника i изменилась (обычно i -- победитель)
+    void replay(std::ptrdiff_t i) {
+        std::ptrdiff_t w=i;
+        for(std::ptrdiff_t t=(i+k)/2;t>0;t/=2)
+        {
+            //пустой узел при построении: оставляем претендента и выходим
+            if(tree[t]<0) { tree[t]=w; return; }
+            if(beats(tree[t],w)) std::swap(tree[t],w);
+        }
+        tree[0]=w;
+    }
+};
+
+}
+
+#endif //SORT_LOSERTREE_H
@@ -0,0 +1,93 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_MSDRADIX_H
+#define SORT_MSDRADIX_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include "Trace.h"
+#include "Radix.h"
+#include "Insertion.h"
+#include "Network.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Корзины не длиннее этого досортировываются сетью
+const std::ptrdiff_t msd_insertion_threshold=32;
+const unsigned msd_bits=8;
+
+//"Американский флаг": подсчёт корзин, затем перестановка на месте циклами
+//обменов -- каждый обмен ставит один элемент в его корзину. Дополнительная
+//память -- только счётчики, O(2^bits) на уровень рекурсии.
+template<class RandomIt, class Trace>
+void msd_radix(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, unsigned shift, unsigned width, Trace &tr)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef RadixKey<T> K;
+    if(hi-lo<=msd_insertion_threshold)
+    {
+        RadixLess<T> comp;
+        small_sort(a,lo,hi,comp,tr);
+        return;
+    }
+    const std::size_t R=std::size_t(1)<<width;
+    const typename K::type mask=typename K::type(R-1);
+    auto digit=[&](std::ptrdiff_t i) { return std::size_t((K::key(a[i])>>shift)&mask); };
+    std::ptrdiff_t count[1<<msd_bits]={0}, head[1<<msd_bits], tail[1<<msd_bits];
+    for(std::ptrdiff_t i=lo;i<hi;i++) count[digit(i)]++;
+    std::ptrdiff_t sum=lo;
+    for(std::size_t d=0;d<R;d++)
+    {
+        head[d]=sum;
+        sum+=count[d];
+        tail[d]=sum;
+    }
+    for(std::size_t b=0;b<R;b++)
+        for(std::ptrdiff_t i=head[b];i<tail[b];i++)
+        {
+            for(std::size_t d=digit(i);d!=b;d=digit(i))
+            {
+                using std::swap;
+                std::ptrdiff_t j=head[d]++;
+                swap(a[i],a[j]);
+                tr.swap(i,j);
+            }
+        }
+    if(shift==0) return;
+    unsigned next=shift>=msd_bits ? msd_bits : shift;
+    std::ptrdiff_t start=lo;
+    for(std::size_t b=0;b<R;b++)
+    {
+        if(tail[b]-start>1) msd_radix(a,start,tail[b],shift-next,next,tr);
+        start=tail[b];
+    }
+}
+
+}
+
+//Поразрядная MSD-сортировка на месте (American flag sort) для тех же ключей,
+//что и radix_sort: не требует буфера O(n), мелкие корзины -- вставками.
+template<class RandomIt, class Trace>
+void msd_radix_sort(RandomIt first, RandomIt last, Trace &tr)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    const unsigned keybits=sizeof(typename RadixKey<T>::type)*8;
+    unsigned width=keybits>=detail::msd_bits ? detail::msd_bits : keybits;
+    detail::msd_radix(first,0,last-first,keybits-width,width,tr);
+}
+
+template<class RandomIt>
+void msd_radix_sort(RandomIt first, RandomIt last)
+{
+    NoTrace tr;
+    msd_radix_sort(first,last,tr);
+}
+
+}
+
+#endif //SORT_MSDRADIX_H
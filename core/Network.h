@@ -0,0 +1,186 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_NETWORK_H
+#define SORT_NETWORK_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "Trace.h"
+#include "Insertion.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Сети строятся для размеров до этого; отрезки не длиннее него базовые
+//случаи рекурсивных сортировок досортировывают сетью, а не вставками
+const std::size_t network_max=32;
+//Компараторов в сети на 32 элемента -- 191
+const std::size_t network_capacity=192;
+
+//Сортирующая сеть: пары индексов (i[k], j[k]), i<j, в порядке применения
+struct Network{
+    unsigned char i[network_capacity], j[network_capacity];
+    std::size_t size;
+    constexpr void add(std::size_t a, std::size_t b) {
+        i[size]=(unsigned char)a;
+        j[size]=(unsigned char)b;
+        size++;
+    }
+};
+
+//Сеть Бэтчера в форме "слияния обменами" (Кнут, алгоритм 5.2.2M) для
+//любого n. До n=8 она совпадает по числу компараторов с оптимальной, дальше
+//длиннее лучших известных на несколько процентов (191 против 185 при n=32),
+//зато строится одним правилом, а не таблицей на каждый размер. Компараторы
+//отдаются в out.add(i,j): при компиляции -- в Network, во время работы --
+//в списки для сетей длиннее network_max.
+template<class Out>
+constexpr void merge_exchange(std::size_t n, Out &out)
+{
+    std::size_t t=0;
+    while((std::size_t(1)<<t)<n) t++;
+    for(std::size_t p=t ? std::size_t(1)<<(t-1) : 0;p>0;p>>=1)
+    {
+        std::size_t q=std::size_t(1)<<(t-1), r=0, d=p;
+        for(;;)
+        {
+            for(std::size_t i=0;i+d<n;i++)
+                if((i&p)==r) out.add(i,i+d);
+            if(q==p) break;
+            d=q-p;
+            q>>=1;
+            r=p;
+        }
+    }
+}
+
+constexpr Network make_network(std::size_t n)
+{
+    Network net{{0},{0},0};
+    merge_exchange(n,net);
+    return net;
+}
+
+template<std::size_t N>
+struct NetworkOf{
+    static_assert(N<=network_max,"сети строятся только для малых размеров");
+    static constexpr Network net=make_network(N);
+};
+
+template<std::size_t N>
+constexpr Network NetworkOf<N>::net;
+
+//Сети выгодны там, где компаратор -- это cmov без ветвлений, а копирование
+//дешёвое: на числах. Для строк и записей остаются вставки.
+template<class T>
+struct use_network : std::integral_constant<bool,std::is_arithmetic<T>::value> {};
+
+template<std::size_t I, std::size_t J, class T, class Compare>
+inline void exchange(T *v, Compare &comp)
+{
+    T x=v[I], y=v[J];
+    bool c=comp(y,x);
+    v[I]=c ? y : x;
+    v[J]=c ? x : y;
+}
+
+//Сеть, развёрнутая в прямую последовательность компараторов над локальной
+//копией: индексы известны при компиляции, и копия живёт в регистрах
+template<std::size_t N, class RandomIt, class Compare, std::size_t... K>
+inline void unrolled(RandomIt a, std::ptrdiff_t lo, Compare &comp, std::index_sequence<K...>)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef NetworkOf<N> Net;
+    T v[N ? N : 1];
+    for(std::size_t k=0;k<N;k++) v[k]=a[lo+(std::ptrdiff_t)k];
+    int unroll[]={0,(exchange<Net::net.i[K],Net::net.j[K]>(v,comp),0)...};
+    (void)unroll;
+    for(std::size_t k=0;k<N;k++) a[lo+(std::ptrdiff_t)k]=v[k];
+}
+
+template<std::size_t N, class RandomIt, class Compare, class Trace>
+void network(RandomIt a, std::ptrdiff_t lo, Compare &comp, Trace &tr)
+{
+    if(Trace::enabled)
+    {
+        //для визуализации -- те же компараторы по одному, с обменами
+        const Network &net=NetworkOf<N>::net;
+        for(std::size_t k=0;k<net.size;k++)
+        {
+            std::ptrdiff_t i=lo+net.i[k], j=lo+net.j[k];
+            tr.compare(j,i);
+            if(comp(a[j],a[i]))
+            {
+                using std::swap;
+                swap(a[i],a[j]);
+                tr.swap(i,j);
+            }
+        }
+        return;
+    }
+    unrolled<N>(a,lo,comp,std::make_index_sequence<NetworkOf<N>::net.size>());
+}
+
+template<class RandomIt, class Compare, class Trace, std::size_t... N>
+void network_dispatch(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t n, Compare &comp, Trace &tr,
+                      std::index_sequence<N...>)
+{
+    typedef void (*Sort)(RandomIt, std::ptrdiff_t, Compare&, Trace&);
+    static const Sort table[]={&network<N,RandomIt,Compare,Trace>...};
+    table[n](a,lo,comp,tr);
+}
+
+template<class RandomIt, class Compare, class Trace>
+void small_sort(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr, std::true_type)
+{
+    if(hi-lo>(std::ptrdiff_t)network_max) insertion(a,lo,hi,comp,tr);
+    else network_dispatch(a,lo,hi-lo,comp,tr,std::make_index_sequence<network_max+1>());
+}
+
+template<class RandomIt, class Compare, class Trace>
+void small_sort(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr, std::false_type)
+{
+    insertion(a,lo,hi,comp,tr);
+}
+
+//Базовый случай рекурсивных сортировок: сеть для чисел до network_max
+//элементов, вставки для остального
+template<class RandomIt, class Compare, class Trace>
+void small_sort(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    small_sort(a,lo,hi,comp,tr,use_network<T>());
+}
+
+}
+
+//Сортирующая сеть на N<=32 элемента начиная с first; сеть строится при
+//компиляции по N и выполняется без ветвлений, если элементы -- числа
+template<std::size_t N, class RandomIt, class Compare, class Trace>
+void network_sort(RandomIt first, Compare comp, Trace &tr)
+{
+    detail::network<N>(first,0,comp,tr);
+}
+
+template<std::size_t N, class RandomIt, class Compare>
+void network_sort(RandomIt first, Compare comp)
+{
+    NoTrace tr;
+    network_sort<N>(first,comp,tr);
+}
+
+template<std::size_t N, class RandomIt>
+void network_sort(RandomIt first)
+{
+    network_sort<N>(first,std::less<>());
+}
+
+}
+
+#endif //SORT_NETWORK_H
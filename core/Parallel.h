@@ -0,0 +1,158 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_PARALLEL_H
+#define SORT_PARALLEL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Trace.h"
+
+namespace sortcore {
+
+//0 -- по числу аппаратных потоков
+inline unsigned threads_or_default(unsigned threads)
+{
+    if(threads) return threads;
+    unsigned hw=std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+namespace detail {
+
+//Выполняет f(0..p-1) в p потоках, f(0) -- в текущем. Исключение из любого
+//потока пробрасывается вызывающему после join всех остальных.
+template<class F>
+void fork_join(unsigned p, F f)
+{
+    std::exception_ptr err;
+    std::mutex m;
+    auto guarded=[&](unsigned i) {
+        try {
+            f(i);
+        }
+        catch(...) {
+            std::lock_guard<std::mutex> lk(m);
+            if(!err) err=std::current_exception();
+        }
+    };
+    std::vector<std::thread> th;
+    for(unsigned i=1;i<p;i++) th.emplace_back(guarded,i);
+    guarded(0);
+    for(auto &t : th) t.join();
+    if(err) std::rethrow_exception(err);
+}
+
+//Постоянные потоки для частых коротких параллельных вызовов: fork_join
+//создаёт потоки на каждый вызов, а пул держит их между вызовами и
+//добавляет, когда просят больше. Вызовы run из разных потоков идут по
+//очереди; f не должна сама вызывать run того же пула.
+class WorkerPool{
+    std::mutex busy, m;
+    std::condition_variable wake, finished;
+    std::vector<std::thread> th;
+    std::function<void(unsigned)> job;
+    unsigned parts=0, pending=0, generation=0;
+    bool stop=false;
+    std::exception_ptr err;
+
+    void call(unsigned i) {
+        try {
+            job(i);
+        }
+        catch(...) {
+            std::lock_guard<std::mutex> lk(m);
+            if(!err) err=std::current_exception();
+        }
+    }
+
+    void loop(unsigned id, unsigned seen) {
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lk(m);
+                wake.wait(lk,[&] { return stop || generation!=seen; });
+                if(stop) return;
+                seen=generation;
+                if(id>=parts) continue;
+            }
+            call(id);
+            std::lock_guard<std::mutex> lk(m);
+            if(--pending==0) finished.notify_all();
+        }
+    }
+
+public:
+    WorkerPool() {}
+    WorkerPool(const WorkerPool&)=delete;
+    WorkerPool &operator=(const WorkerPool&)=delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            stop=true;
+        }
+        wake.notify_all();
+        for(auto &t : th) t.join();
+    }
+
+    //Как fork_join: f(0..p-1), f(0) -- в текущем потоке, исключение
+    //пробрасывается после завершения всех частей
+    template<class F>
+    void run(unsigned p, F f) {
+        std::lock_guard<std::mutex> one(busy);
+        {
+            std::lock_guard<std::mutex> lk(m);
+            while(th.size()+1<p) th.emplace_back(&WorkerPool::loop,this,(unsigned)th.size()+1,generation);
+            job=f;
+            parts=p;
+            pending=p-1;
+            err=nullptr;
+            generation++;
+        }
+        wake.notify_all();
+        call(0);
+        std::unique_lock<std::mutex> lk(m);
+        finished.wait(lk,[&] { return pending==0; });
+        job=nullptr;
+        if(err) std::rethrow_exception(err);
+    }
+};
+
+}
+
+//Сериализует вызовы трассировки из нескольких потоков. Для NoTrace не нужна:
+//пустые вызовы потокобезопасны сами по себе.
+template<class Trace>
+class LockedTrace{
+    Trace &tr;
+    std::mutex m;
+public:
+    static constexpr bool enabled=Trace::enabled;
+    explicit LockedTrace(Trace &tr) : tr(tr) {}
+    void compare(std::ptrdiff_t i, std::ptrdiff_t j) {
+        std::lock_guard<std::mutex> lk(m);
+        tr.compare(i,j);
+    }
+    void swap(std::ptrdiff_t i, std::ptrdiff_t j) {
+        std::lock_guard<std::mutex> lk(m);
+        tr.swap(i,j);
+    }
+    template<class T> void write(std::ptrdiff_t i, const T &v) {
+        std::lock_guard<std::mutex> lk(m);
+        tr.write(i,v);
+    }
+    void run(std::ptrdiff_t lo, std::ptrdiff_t hi) {
+        std::lock_guard<std::mutex> lk(m);
+        tr.run(lo,hi);
+    }
+};
+
+}
+
+#endif //SORT_PARALLEL_H
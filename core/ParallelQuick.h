@@ -0,0 +1,220 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_PARALLELQUICK_H
+#define SORT_PARALLELQUICK_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Trace.h"
+#include "Parallel.h"
+#include "Quick.h"
+#include "Pdq.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Отрезки длиннее этого на поток разбиваются всеми потоками сразу
+const std::ptrdiff_t parallel_partition_grain=1<<15;
+//Задачи короче этого не дробятся, а сортируются последовательно (pdqsort)
+const std::ptrdiff_t steal_grain=1<<13;
+
+struct Range{
+    std::ptrdiff_t lo, hi;
+};
+
+//Дек задач одного потока: владелец работает с конца, воры забирают с начала
+//(там лежат самые старые и крупные отрезки)
+class StealDeque{
+    std::mutex m;
+    std::deque<Range> d;
+public:
+    void push(Range r) {
+        std::lock_guard<std::mutex> lk(m);
+        d.push_back(r);
+    }
+    bool pop(Range &r) {
+        std::lock_guard<std::mutex> lk(m);
+        if(d.empty()) return false;
+        r=d.back();
+        d.pop_back();
+        return true;
+    }
+    bool steal(Range &r) {
+        std::lock_guard<std::mutex> lk(m);
+        if(d.empty()) return false;
+        r=d.front();
+        d.pop_front();
+        return true;
+    }
+};
+
+//Разбиение a[lo..hi): сначала элементы с pred, потом без
+template<class RandomIt, class Pred, class Trace>
+std::ptrdiff_t seq_partition(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Pred &pred, Trace &tr)
+{
+    for(;;)
+    {
+        while(lo<hi) { tr.compare(lo,lo); if(!pred(a[lo])) break; ++lo; }
+        while(lo<hi) { tr.compare(hi-1,hi-1); if(pred(a[hi-1])) break; --hi; }
+        if(hi-lo<2) return lo;
+        swap_at(a,lo,hi-1,tr);
+        ++lo; --hi;
+    }
+}
+
+//Параллельное разбиение: каждый из p потоков разбивает свой кусок, затем
+//элементы, оказавшиеся не по ту сторону общей границы, попарно меняются
+//местами -- эту работу тоже делят поровну между потоками
+template<class RandomIt, class Pred, class Trace>
+std::ptrdiff_t parallel_partition(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Pred pred, unsigned p, Trace &tr)
+{
+    std::ptrdiff_t n=hi-lo;
+    std::vector<std::ptrdiff_t> start(p+1), mid(p);
+    for(unsigned c=0;c<=p;c++) start[c]=lo+n*(std::ptrdiff_t)c/(std::ptrdiff_t)p;
+    fork_join(p,[&](unsigned c) { mid[c]=seq_partition(a,start[c],start[c+1],pred,tr); });
+    std::ptrdiff_t m=lo;
+    for(unsigned c=0;c<p;c++) m+=mid[c]-start[c];
+    //big -- элементы без pred левее m, small -- с pred правее m
+    std::vector<Range> big, small;
+    std::vector<std::ptrdiff_t> bigsum(1,0), smallsum(1,0);
+    for(unsigned c=0;c<p;c++)
+    {
+        Range b{std::max(mid[c],lo),std::min(start[c+1],m)};
+        if(b.lo<b.hi) { big.push_back(b); bigsum.push_back(bigsum.back()+b.hi-b.lo); }
+        Range s{std::max(start[c],m),std::min(mid[c],hi)};
+        if(s.lo<s.hi) { small.push_back(s); smallsum.push_back(smallsum.back()+s.hi-s.lo); }
+    }
+    std::ptrdiff_t total=bigsum.back();
+    if(total==0) return m;
+    fork_join(p,[&](unsigned c) {
+        std::ptrdiff_t k=total*c/p, end=total*(c+1)/p;
+        if(k>=end) return;
+        std::size_t bi=std::upper_bound(bigsum.begin(),bigsum.end(),k)-bigsum.begin()-1;
+        std::size_t si=std::upper_bound(smallsum.begin(),smallsum.end(),k)-smallsum.begin()-1;
+        std::ptrdiff_t x=big[bi].lo+k-bigsum[bi], y=small[si].lo+k-smallsum[si];
+        for(;k<end;k++)
+        {
+            if(x==big[bi].hi) x=big[++bi].lo;
+            if(y==small[si].hi) y=small[++si].lo;
+            swap_at(a,x++,y++,tr);
+        }
+    });
+    return m;
+}
+
+//Верхние уровни рекурсии: отрезок разбивается группой из t потоков, затем
+//группа делится пропорционально размерам половин. Итог -- отрезки для задач.
+template<class RandomIt, class Compare, class Trace>
+void parallel_split(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, unsigned t, Compare &comp, Trace &tr,
+                    std::vector<Range> &out, std::mutex &m)
+{
+    if(t<=1 || hi-lo<(std::ptrdiff_t)t*parallel_partition_grain)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        out.push_back({lo,hi});
+        return;
+    }
+    std::ptrdiff_t mid=lo+(hi-lo)/2;
+    sort3(a,lo,mid,hi-1,comp,tr);
+    auto pivot=a[mid];
+    std::ptrdiff_t p=parallel_partition(a,lo,hi,[&](const decltype(pivot) &x) { return comp(x,pivot); },t,tr);
+    if(p==lo)
+    {
+        //меньших опорного нет: отделяем равные ему, их сортировать не нужно
+        p=parallel_partition(a,lo,hi,[&](const decltype(pivot) &x) { return !comp(pivot,x); },t,tr);
+        parallel_split(a,p,hi,t,comp,tr,out,m);
+        return;
+    }
+    unsigned tl=(unsigned)((double)t*(p-lo)/(hi-lo)+0.5);
+    tl=std::min(std::max(tl,1u),t-1);
+    fork_join(2,[&](unsigned i) {
+        if(i==0) parallel_split(a,lo,p,tl,comp,tr,out,m);
+        else parallel_split(a,p,hi,t-tl,comp,tr,out,m);
+    });
+}
+
+template<class RandomIt, class Compare, class Trace>
+void parallel_quick(RandomIt a, std::ptrdiff_t n, Compare &comp, Trace &tr, unsigned p)
+{
+    std::vector<Range> seeds;
+    std::mutex m;
+    parallel_split(a,0,n,p,comp,tr,seeds,m);
+    std::vector<StealDeque> dq(p);
+    for(std::size_t i=0;i<seeds.size();i++) dq[i%p].push(seeds[i]);
+    //отрезки, которые ещё лежат в деках или обрабатываются
+    std::atomic<std::ptrdiff_t> pending((std::ptrdiff_t)seeds.size());
+    std::atomic<bool> failed(false);
+    fork_join(p,[&](unsigned w) {
+        try {
+            Range r;
+            while(pending.load()>0 && !failed.load())
+            {
+                bool got=dq[w].pop(r);
+                for(unsigned s=1;!got && s<p;s++) got=dq[(w+s)%p].steal(r);
+                if(!got)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                while(r.hi-r.lo>steal_grain)
+                {
+                    std::ptrdiff_t mid=hoare_partition(a,r.lo,r.hi,comp,tr);
+                    ++pending;
+                    dq[w].push({mid,r.hi});
+                    r.hi=mid;
+                }
+                //leftmost: соседний отрезок в это время сортирует другой поток
+                pdq(a,r.lo,r.hi,comp,tr,log2_floor(r.hi-r.lo),true);
+                --pending;
+            }
+        }
+        catch(...) {
+            failed=true;
+            throw;
+        }
+    });
+}
+
+}
+
+//Параллельная быстрая сортировка: крупные отрезки разбиваются всеми потоками,
+//остальное раздаётся задачами через деки с кражей работы. При включённой
+//трассировке вызовы сериализуются, и трасса показывает чередование потоков.
+template<class RandomIt, class Compare, class Trace>
+void parallel_quick_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr, unsigned threads=0)
+{
+    unsigned p=threads_or_default(threads);
+    if(Trace::enabled)
+    {
+        LockedTrace<Trace> lt(tr);
+        detail::parallel_quick(first,last-first,comp,lt,p);
+    }
+    else detail::parallel_quick(first,last-first,comp,tr,p);
+}
+
+template<class RandomIt, class Compare>
+void parallel_quick_sort(RandomIt first, RandomIt last, Compare comp, unsigned threads=0)
+{
+    NoTrace tr;
+    parallel_quick_sort(first,last,comp,tr,threads);
+}
+
+template<class RandomIt>
+void parallel_quick_sort(RandomIt first, RandomIt last)
+{
+    parallel_quick_sort(first,last,std::less<>());
+}
+
+}
+
+#endif //SORT_PARALLELQUICK_H
@@ -0,0 +1,222 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_PDQ_H
+#define SORT_PDQ_H
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "Trace.h"
+#include "Insertion.h"
+#include "Network.h"
+#include "Quick.h"
+#include "Heap.h"
+
+namespace sortcore {
+
+namespace detail {
+
+const std::ptrdiff_t pdq_insertion_threshold=24;
+//Начиная с этой длины опорный -- псевдомедиана девяти
+const std::ptrdiff_t pdq_ninther_threshold=128;
+//Сколько сдвигов разрешено пробной сортировке вставками уже разбитого отрезка
+const std::ptrdiff_t pdq_partial_insertion_limit=8;
+
+//Вставками, но сдаётся после limit сдвигов; true -- отрезок отсортирован
+template<class RandomIt, class Compare, class Trace>
+bool partial_insertion(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    std::ptrdiff_t moved=0;
+    for(std::ptrdiff_t i=lo+1;i<hi;i++)
+    {
+        tr.compare(i,i-1);
+        if(!comp(a[i],a[i-1])) continue;
+        auto v=std::move(a[i]);
+        std::ptrdiff_t j=i;
+        do
+        {
+            a[j]=std::move(a[j-1]);
+            tr.write(j,a[j]);
+            --j;
+            if(j==lo) break;
+            tr.compare(i,j-1);
+        } while(comp(v,a[j-1]));
+        a[j]=std::move(v);
+        tr.write(j,a[j]);
+        moved+=i-j;
+        if(moved>pdq_partial_insertion_limit) return false;
+    }
+    return true;
+}
+
+//Опорный в a[lo]. Делит на < pivot | pivot | >= pivot, возвращает позицию
+//опорного и признак того, что ни одного обмена не понадобилось.
+template<class RandomIt, class Compare, class Trace>
+std::pair<std::ptrdiff_t,bool> partition_right(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    auto pivot=a[lo];
+    std::ptrdiff_t first=lo, last=hi;
+    //выбор медианы гарантирует, что справа есть элемент >= pivot
+    do { ++first; tr.compare(first,lo); } while(comp(a[first],pivot));
+    if(first-1==lo)
+        while(first<last) { --last; tr.compare(last,lo); if(comp(a[last],pivot)) break; }
+    else
+        do { --last; tr.compare(last,lo); } while(!comp(a[last],pivot));
+    bool already=first>=last;
+    while(first<last)
+    {
+        swap_at(a,first,last,tr);
+        do { ++first; tr.compare(first,lo); } while(comp(a[first],pivot));
+        do { --last; tr.compare(last,lo); } while(!comp(a[last],pivot));
+    }
+    std::ptrdiff_t p=first-1;
+    if(p!=lo) swap_at(a,lo,p,tr);
+    return {p,already};
+}
+
+//Опорный в a[lo] равен элементу левее отрезка, то есть меньших нет. Делит на
+//<= pivot | > pivot; левую часть сортировать уже не нужно.
+template<class RandomIt, class Compare, class Trace>
+std::ptrdiff_t partition_left(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    auto pivot=a[lo];
+    std::ptrdiff_t first=lo, last=hi;
+    do { --last; tr.compare(lo,last); } while(comp(pivot,a[last]));
+    if(last+1==hi)
+        while(first<last) { ++first; tr.compare(lo,first); if(comp(pivot,a[first])) break; }
+    else
+        do { ++first; tr.compare(lo,first); } while(!comp(pivot,a[first]));
+    while(first<last)
+    {
+        swap_at(a,first,last,tr);
+        do { --last; tr.compare(lo,last); } while(comp(pivot,a[last]));
+        do { ++first; tr.compare(lo,first); } while(!comp(pivot,a[first]));
+    }
+    if(last!=lo) swap_at(a,lo,last,tr);
+    return last;
+}
+
+template<class RandomIt, class Compare, class Trace>
+void pdq(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr, int bad_allowed, bool leftmost)
+{
+    for(;;)
+    {
+        std::ptrdiff_t size=hi-lo;
+        if(size<pdq_insertion_threshold)
+        {
+            small_sort(a,lo,hi,comp,tr);
+            return;
+        }
+        std::ptrdiff_t s2=size/2;
+        if(size>pdq_ninther_threshold)
+        {
+            sort3(a,lo,lo+s2,hi-1,comp,tr);
+            sort3(a,lo+1,lo+s2-1,hi-2,comp,tr);
+            sort3(a,lo+2,lo+s2+1,hi-3,comp,tr);
+            sort3(a,lo+s2-1,lo+s2,lo+s2+1,comp,tr);
+            swap_at(a,lo,lo+s2,tr);
+        }
+        else sort3(a,lo+s2,lo,hi-1,comp,tr);
+        //опорный равен опорному предыдущего уровня: много одинаковых ключей
+        if(!leftmost && !less_at(a,lo-1,lo,comp,tr))
+        {
+            lo=partition_left(a,lo,hi,comp,tr)+1;
+            continue;
+        }
+        std::pair<std::ptrdiff_t,bool> r=partition_right(a,lo,hi,comp,tr);
+        std::ptrdiff_t p=r.first, ls=p-lo, rs=hi-(p+1);
+        if(ls<size/8 || rs<size/8)
+        {
+            //слишком много плохих разбиений -- гарантированный O(n log n)
+            if(--bad_allowed==0)
+            {
+                heap(a,lo,hi,comp,tr);
+                return;
+            }
+            //ломаем закономерность во входе, которая дала плохой опорный
+            if(ls>=pdq_insertion_threshold)
+            {
+                swap_at(a,lo,lo+ls/4,tr);
+                swap_at(a,p-1,p-ls/4,tr);
+                if(ls>pdq_ninther_threshold)
+                {
+                    swap_at(a,lo+1,lo+ls/4+1,tr);
+                    swap_at(a,lo+2,lo+ls/4+2,tr);
+                    swap_at(a,p-2,p-(ls/4+1),tr);
+                    swap_at(a,p-3,p-(ls/4+2),tr);
+                }
+            }
+            if(rs>=pdq_insertion_threshold)
+            {
+                swap_at(a,p+1,p+1+rs/4,tr);
+                swap_at(a,hi-1,hi-rs/4,tr);
+                if(rs>pdq_ninther_threshold)
+                {
+                    swap_at(a,p+2,p+2+rs/4,tr);
+                    swap_at(a,p+3,p+3+rs/4,tr);
+                    swap_at(a,hi-2,hi-(1+rs/4),tr);
+                    swap_at(a,hi-3,hi-(2+rs/4),tr);
+                }
+            }
+        }
+        //разбиение без единого обмена: вход, скорее всего, уже почти упорядочен
+        else if(r.second && partial_insertion(a,lo,p,comp,tr) && partial_insertion(a,p+1,hi,comp,tr))
+            return;
+        pdq(a,lo,p,comp,tr,bad_allowed,leftmost);
+        lo=p+1;
+        leftmost=false;
+    }
+}
+
+inline int log2_floor(std::ptrdiff_t n)
+{
+    int l=0;
+    while(n>>=1) l++;
+    return l;
+}
+
+}
+
+//Pattern-defeating quicksort -- сортировка сравнениями по умолчанию: вставки на
+//коротких отрезках, медиана трёх или девяти, распознавание уже разбитых
+//отрезков, отдельный проход для равных ключей, слом закономерностей и
+//пирамидальная сортировка после log n плохих разбиений.
+template<class RandomIt, class Compare, class Trace>
+void pdq_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    std::ptrdiff_t n=last-first;
+    if(n<2) return;
+    detail::pdq(first,0,n,comp,tr,detail::log2_floor(n),true);
+}
+
+template<class RandomIt, class Compare>
+void pdq_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    pdq_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void pdq_sort(RandomIt first, RandomIt last)
+{
+    pdq_sort(first,last,std::less<>());
+}
+
+//Сортировка сравнениями по умолчанию
+template<class RandomIt, class Compare>
+void sort(RandomIt first, RandomIt last, Compare comp)
+{
+    pdq_sort(first,last,comp);
+}
+
+template<class RandomIt>
+void sort(RandomIt first, RandomIt last)
+{
+    pdq_sort(first,last);
+}
+
+}
+
+#endif //SORT_PDQ_H
@@ -0,0 +1,173 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Perf.h"
+#include <cstdio>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sortcore {
+
+const char *name(Counter c)
+{
+    switch(c)
+    {
+        case Counter::Cycles: return "Тактов";
+        case Counter::Instructions: return "Инструкций";
+        case Counter::BranchMisses: return "Промахов ветвлений";
+        case Counter::L1dMisses: return "Промахов L1d";
+        case Counter::LlcMisses: return "Промахов LLC";
+        case Counter::DtlbMisses: return "Промахов dTLB";
+    }
+    return "";
+}
+
+const char *id(Counter c)
+{
+    switch(c)
+    {
+        case Counter::Cycles: return "cycles";
+        case Counter::Instructions: return "instructions";
+        case Counter::BranchMisses: return "branch_misses";
+        case Counter::L1dMisses: return "l1d_misses";
+        case Counter::LlcMisses: return "llc_misses";
+        case Counter::DtlbMisses: return "dtlb_misses";
+    }
+    return "";
+}
+
+bool PerfStats::any() const
+{
+    for(bool v : valid)
+        if(v) return true;
+    return false;
+}
+
+#ifdef __linux__
+
+namespace {
+
+std::uint64_t cache_event(std::uint64_t cache, std::uint64_t result)
+{
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ<<8) | (result<<16);
+}
+
+int open_counter(Counter c)
+{
+    perf_event_attr attr;
+    std::memset(&attr,0,sizeof(attr));
+    attr.size=sizeof(attr);
+    attr.type=PERF_TYPE_HARDWARE;
+    switch(c)
+    {
+        case Counter::Cycles: attr.config=PERF_COUNT_HW_CPU_CYCLES; break;
+        case Counter::Instructions: attr.config=PERF_COUNT_HW_INSTRUCTIONS; break;
+        case Counter::BranchMisses: attr.config=PERF_COUNT_HW_BRANCH_MISSES; break;
+        case Counter::LlcMisses: attr.config=PERF_COUNT_HW_CACHE_MISSES; break;
+        case Counter::L1dMisses:
+            attr.type=PERF_TYPE_HW_CACHE;
+            attr.config=cache_event(PERF_COUNT_HW_CACHE_L1D,PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        case Counter::DtlbMisses:
+            attr.type=PERF_TYPE_HW_CACHE;
+            attr.config=cache_event(PERF_COUNT_HW_CACHE_DTLB,PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+    }
+    attr.disabled=1;
+    attr.inherit=1;
+    attr.exclude_kernel=1;
+    attr.exclude_hv=1;
+    attr.read_format=PERF_FORMAT_TOTAL_TIME_ENABLED|PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open,&attr,0,-1,-1,0);
+}
+
+}
+
+PerfCounters::PerfCounters()
+{
+    for(unsigned i=0;i<counter_count;i++) fd[i]=open_counter(counters[i]);
+}
+
+PerfCounters::~PerfCounters()
+{
+    for(int f : fd)
+        if(f>=0) close(f);
+}
+
+bool PerfCounters::available() const
+{
+    for(int f : fd)
+        if(f>=0) return true;
+    return false;
+}
+
+void PerfCounters::start()
+{
+    for(int f : fd)
+        if(f>=0) {
+            ioctl(f,PERF_EVENT_IOC_RESET,0);
+            ioctl(f,PERF_EVENT_IOC_ENABLE,0);
+        }
+}
+
+PerfStats PerfCounters::stop()
+{
+    PerfStats s;
+    for(int f : fd)
+        if(f>=0) ioctl(f,PERF_EVENT_IOC_DISABLE,0);
+    for(unsigned i=0;i<counter_count;i++)
+    {
+        std::uint64_t r[3]; //значение, время включения, время на процессоре
+        if(fd[i]<0 || read(fd[i],r,sizeof(r))!=(ssize_t)sizeof(r) || r[2]==0) continue;
+        s.value[i]=r[2]<r[1] ? (std::uint64_t)((double)r[0]*r[1]/r[2]) : r[0];
+        s.valid[i]=true;
+    }
+    return s;
+}
+
+#else
+
+PerfCounters::PerfCounters()
+{
+    for(int &f : fd) f=-1;
+}
+
+PerfCounters::~PerfCounters() {}
+
+bool PerfCounters::available() const
+{
+    return false;
+}
+
+void PerfCounters::start() {}
+
+PerfStats PerfCounters::stop()
+{
+    return PerfStats();
+}
+
+#endif
+
+std::string describe(const PerfStats &s)
+{
+    if(!s.any()) return "Счётчики процессора недоступны";
+    std::string out;
+    char buf[64];
+    for(unsigned i=0;i<counter_count;i++)
+    {
+        if(!s.valid[i]) continue;
+        std::snprintf(buf,sizeof(buf),"%s%s: %llu",out.empty() ? "" : "\n",name(counters[i]),
+                      (unsigned long long)s.value[i]);
+        out+=buf;
+    }
+    return out;
+}
+
+}
@@ -0,0 +1,53 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_PERF_H
+#define SORT_PERF_H
+
+#include <cstdint>
+#include <string>
+
+namespace sortcore {
+
+enum class Counter{Cycles, Instructions, BranchMisses, L1dMisses, LlcMisses, DtlbMisses};
+
+const Counter counters[]={Counter::Cycles, Counter::Instructions, Counter::BranchMisses,
+                          Counter::L1dMisses, Counter::LlcMisses, Counter::DtlbMisses};
+const unsigned counter_count=sizeof(counters)/sizeof(counters[0]);
+
+const char *name(Counter c);
+const char *id(Counter c);
+
+//Показания за один замер; счётчик, который ядро или железо не дали открыть,
+//помечен valid=false
+struct PerfStats{
+    std::uint64_t value[counter_count]={};
+    bool valid[counter_count]={};
+    bool any() const;
+};
+
+//Аппаратные счётчики процессора через perf_event_open (только Linux).
+//Считается текущий поток и потоки, созданные им после открытия счётчиков,
+//поэтому параллельные ядра, запускающие потоки внутри сортировки, учтены
+//целиком. При мультиплексировании значения масштабируются по доле времени,
+//которое счётчик реально был на процессоре.
+class PerfCounters{
+    int fd[counter_count];
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&)=delete;
+    PerfCounters &operator=(const PerfCounters&)=delete;
+    //Открылся ли хоть один счётчик (мешает perf_event_paranoid, контейнер, ВМ)
+    bool available() const;
+    void start();
+    PerfStats stop();
+};
+
+//Строки для подписи шага: "Тактов: ...", по одной на счётчик
+std::string describe(const PerfStats &s);
+
+}
+
+#endif //SORT_PERF_H
@@ -0,0 +1,100 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Playback.h"
+#include "Dispatch.h"
+
+namespace sortcore {
+
+class Playback::QueueTrace{
+    Playback &p;
+public:
+    static constexpr bool enabled=true;
+    Stats stats;
+    explicit QueueTrace(Playback &p) : p(p) {}
+    void compare(std::ptrdiff_t, std::ptrdiff_t) {++stats.comparisons;}
+    void swap(std::ptrdiff_t i, std::ptrdiff_t j) {
+        ++stats.swaps;
+        p.push({Op::Swap,(int)i,(int)j});
+    }
+    template<class T> void write(std::ptrdiff_t i, const T &v) {
+        ++stats.writes;
+        p.push({Op::Write,(int)i,(int)v});
+    }
+    void run(std::ptrdiff_t lo, std::ptrdiff_t hi) {p.push({Op::Run,(int)lo,(int)hi});}
+};
+
+Playback::Playback(Algorithm a, std::vector<int> v, const Options &opt, std::size_t lookahead)
+    : tl(v), lookahead(lookahead ? lookahead : 1)
+{
+    producer=std::thread(&Playback::produce,this,a,std::move(v),opt);
+}
+
+Playback::~Playback()
+{
+    {
+        std::lock_guard<std::mutex> lk(m);
+        cancel=true;
+    }
+    cv.notify_all();
+    if(producer.joinable()) producer.join();
+}
+
+void Playback::push(Op op)
+{
+    std::unique_lock<std::mutex> lk(m);
+    cv.wait(lk,[this]{ return cancel || q.size()<lookahead; });
+    //раскручиваем стек ядра, если окно закрыли на середине сортировки
+    if(cancel) throw Cancelled();
+    q.push_back(op);
+    cv.notify_all();
+}
+
+void Playback::produce(Algorithm a, std::vector<int> v, Options opt)
+{
+    QueueTrace tr(*this);
+    std::vector<int> copy;
+    if(opt.counters) copy=v;
+    try {
+        run(a,v,opt,tr);
+    }
+    catch(const Cancelled&) {
+        return;
+    }
+    std::string text=summary(tr.stats);
+    if(opt.counters) text+="\n"+describe(profile(a,copy,opt));
+    std::lock_guard<std::mutex> lk(m);
+    last=text;
+    q.push_back({Op::Done,0,0});
+    cv.notify_all();
+}
+
+bool Playback::fetch(std::size_t k)
+{
+    while(tl.size()<=k)
+    {
+        Op op;
+        {
+            std::unique_lock<std::mutex> lk(m);
+            if(q.empty() && !producer.joinable()) return false;
+            cv.wait(lk,[this]{ return !q.empty(); });
+            op=q.front();
+            q.pop_front();
+            cv.notify_all();
+        }
+        switch(op.kind)
+        {
+            case Op::Swap: tl.swap(op.i,op.arg); break;
+            case Op::Write: tl.write(op.i,op.arg); break;
+            case Op::Run: tl.run(op.i,op.arg); break;
+            case Op::Done:
+                tl.note(last);
+                producer.join();
+                break;
+        }
+    }
+    return true;
+}
+
+}
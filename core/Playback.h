@@ -0,0 +1,60 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_PLAYBACK_H
+#define SORT_PLAYBACK_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Algorithm.h"
+#include "Timeline.h"
+
+namespace sortcore {
+
+//Ленивое воспроизведение трассы. Ядро работает в отдельном потоке как
+//генератор: каждая операция кладётся в очередь упреждения ёмкостью lookahead,
+//и поток засыпает, пока очередь полна. В Timeline шаги попадают только когда
+//их запросили через fetch, поэтому первый кадр доступен сразу, а в памяти
+//лежит лишь просмотренная часть трассы плюс упреждение.
+class Playback{
+    struct Op{
+        enum Kind{Swap, Write, Run, Done} kind;
+        int i, arg;
+    };
+    struct Cancelled{};
+    class QueueTrace;
+    Timeline tl;
+    std::deque<Op> q;
+    std::size_t lookahead;
+    std::string last;
+    bool cancel=false;
+    std::mutex m;
+    std::condition_variable cv;
+    std::thread producer;
+    void produce(Algorithm a, std::vector<int> v, Options opt);
+    void push(Op op);
+public:
+    Playback(Algorithm a, std::vector<int> v, const Options &opt=Options(), std::size_t lookahead=256);
+    ~Playback();
+    Playback(const Playback&)=delete;
+    Playback &operator=(const Playback&)=delete;
+    //Дожидается шага k; false, если трасса закончилась раньше
+    bool fetch(std::size_t k);
+    //Число уже полученных шагов
+    std::size_t size() const { return tl.size(); }
+    const std::vector<int> &at(std::size_t k) { return tl.at(k); }
+    std::pair<int,int> touched(std::size_t k) const { return tl.touched(k); }
+    std::string text(std::size_t k) const { return tl.text(k); }
+    State state(std::size_t k) { return tl.state(k); }
+};
+
+}
+
+#endif //SORT_PLAYBACK_H
@@ -0,0 +1,231 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_QUICK_H
+#define SORT_QUICK_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "Trace.h"
+#include "Insertion.h"
+#include "Network.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Отрезки короче этого досортировываются сетью (числа) или вставками
+const std::ptrdiff_t insertion_threshold=16;
+//Блок блочного разбиения: смещения помещаются в unsigned char
+const std::ptrdiff_t partition_block=64;
+//Начиная с этой длины блочная быстрая берёт опорным псевдомедиану девяти
+const std::ptrdiff_t block_ninther_threshold=128;
+
+template<class RandomIt, class Trace>
+void swap_at(RandomIt a, std::ptrdiff_t i, std::ptrdiff_t j, Trace &tr)
+{
+    using std::swap;
+    swap(a[i],a[j]);
+    tr.swap(i,j);
+}
+
+template<class RandomIt, class Compare, class Trace>
+bool less_at(RandomIt a, std::ptrdiff_t i, std::ptrdiff_t j, Compare &comp, Trace &tr)
+{
+    tr.compare(i,j);
+    return comp(a[i],a[j]);
+}
+
+//Упорядочивает a[i] <= a[j] <= a[k]
+template<class RandomIt, class Compare, class Trace>
+void sort3(RandomIt a, std::ptrdiff_t i, std::ptrdiff_t j, std::ptrdiff_t k, Compare &comp, Trace &tr)
+{
+    if(less_at(a,j,i,comp,tr)) swap_at(a,i,j,tr);
+    if(less_at(a,k,j,comp,tr))
+    {
+        swap_at(a,j,k,tr);
+        if(less_at(a,j,i,comp,tr)) swap_at(a,i,j,tr);
+    }
+}
+
+//Разбиение Хоара a[lo..hi) по медиане трёх; возвращает p: a[lo..p) <= a[p..hi)
+template<class RandomIt, class Compare, class Trace>
+std::ptrdiff_t hoare_partition(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    std::ptrdiff_t mid=lo+(hi-1-lo)/2;
+    sort3(a,lo,mid,hi-1,comp,tr);
+    auto pivot=a[mid];
+    std::ptrdiff_t i=lo-1, j=hi;
+    for(;;)
+    {
+        do { ++i; tr.compare(i,mid); } while(comp(a[i],pivot));
+        do { --j; tr.compare(j,mid); } while(comp(pivot,a[j]));
+        if(i>=j) return j+1;
+        swap_at(a,i,j,tr);
+    }
+}
+
+//Сторона блочного разбиения: Le=false -- влево x<pivot, Le=true -- x<=pivot
+template<class T, class Compare, bool Le>
+struct GoesLeft{
+    const T &pivot;
+    Compare &comp;
+    bool operator()(const T &x) const { return Le ? !comp(pivot,x) : comp(x,pivot); }
+};
+
+//Заполняет смещения элементов блока с шагом dir от base, которые не на своей
+//стороне: счётчик растёт на результат сравнения, ветвлений по данным нет
+template<class RandomIt, class Left, class Trace>
+std::ptrdiff_t block_offsets(RandomIt a, std::ptrdiff_t base, std::ptrdiff_t dir, std::ptrdiff_t size,
+                             bool left, unsigned char *off, Left &goes_left, std::ptrdiff_t lo, Trace &tr)
+{
+    std::ptrdiff_t n=0;
+    for(std::ptrdiff_t i=0;i<size;i++)
+    {
+        off[n]=(unsigned char)i;
+        tr.compare(base+dir*i,lo);
+        n+=goes_left(a[base+dir*i])!=left;
+    }
+    return n;
+}
+
+//Блочное разбиение (BlockQuicksort, Эделькамп и Вайс): опорный в a[lo].
+//Смещения элементов не на своей стороне копятся в двух буферах по блоку
+//слева и справа, затем попарно меняются местами. Исход сравнения идёт в
+//арифметику, а не в переход, так что на случайных ключах нет промахов
+//предсказания, которыми разбиение Хоара теряет до половины времени.
+//Делит на левые | pivot | остальные, возвращает позицию опорного.
+template<bool Le, class RandomIt, class Compare, class Trace>
+std::ptrdiff_t block_partition(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    const T pivot=a[lo];
+    GoesLeft<T,Compare,Le> goes_left{pivot,comp};
+    unsigned char ol[partition_block], orr[partition_block];
+    std::ptrdiff_t first=lo+1, last=hi, nl=0, nr=0, sl=0, sr=0;
+    for(;;)
+    {
+        std::ptrdiff_t unknown=last-first, ls=partition_block, rs=partition_block;
+        bool tail=unknown<=2*partition_block;
+        if(tail)
+        {
+            //остаток делится между пустыми буферами
+            unknown-=(nl || nr) ? partition_block : 0;
+            if(nr) ls=unknown;
+            else if(nl) rs=unknown;
+            else { ls=unknown/2; rs=unknown-ls; }
+        }
+        if(nl==0) { sl=0; nl=block_offsets(a,first,1,ls,true,ol,goes_left,lo,tr); }
+        if(nr==0) { sr=0; nr=block_offsets(a,last-1,-1,rs,false,orr,goes_left,lo,tr); }
+        std::ptrdiff_t num=nl<nr ? nl : nr;
+        for(std::ptrdiff_t k=0;k<num;k++) swap_at(a,first+ol[sl+k],last-1-orr[sr+k],tr);
+        nl-=num; nr-=num; sl+=num; sr+=num;
+        if(nl==0) first+=ls;
+        if(nr==0) last-=rs;
+        if(tail) break;
+    }
+    //в одном из буферов могли остаться смещения: остальное в нём уже на месте,
+    //и чужие элементы сдвигаются к границе с неразобранной стороны
+    if(nl)
+    {
+        while(nl) swap_at(a,first+ol[sl+--nl],--last,tr);
+        first=last;
+    }
+    while(nr) swap_at(a,last-1-orr[sr+--nr],first++,tr);
+    std::ptrdiff_t p=first-1;
+    if(p!=lo) swap_at(a,lo,p,tr);
+    return p;
+}
+
+//Быстрая сортировка на блочном разбиении; если меньших опорного нет, равные
+//ему отделяются вторым разбиением и больше не трогаются
+template<class RandomIt, class Compare, class Trace>
+void block_quick(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    while(hi-lo>insertion_threshold)
+    {
+        std::ptrdiff_t s2=(hi-lo)/2;
+        //блочный обмен перемешивает порядок внутри частей, и медиана трёх на
+        //почти упорядоченном входе часто промахивается -- на длинных отрезках
+        //берётся псевдомедиана девяти
+        if(hi-lo>block_ninther_threshold)
+        {
+            sort3(a,lo,lo+s2,hi-1,comp,tr);
+            sort3(a,lo+1,lo+s2-1,hi-2,comp,tr);
+            sort3(a,lo+2,lo+s2+1,hi-3,comp,tr);
+            sort3(a,lo+s2-1,lo+s2,lo+s2+1,comp,tr);
+        }
+        else sort3(a,lo,lo+s2,hi-1,comp,tr);
+        swap_at(a,lo,lo+s2,tr);
+        std::ptrdiff_t p=block_partition<false>(a,lo,hi,comp,tr);
+        if(p==lo)
+        {
+            lo=block_partition<true>(a,lo,hi,comp,tr)+1;
+            continue;
+        }
+        if(p-lo<hi-p) { block_quick(a,lo,p,comp,tr); lo=p+1; }
+        else { block_quick(a,p+1,hi,comp,tr); hi=p; }
+    }
+    small_sort(a,lo,hi,comp,tr);
+}
+
+template<class RandomIt, class Compare, class Trace>
+void quick(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    while(hi-lo>insertion_threshold)
+    {
+        std::ptrdiff_t p=hoare_partition(a,lo,hi,comp,tr);
+        //рекурсия в меньшую часть, цикл по большей: глубина стека O(log n)
+        if(p-lo<hi-p) { quick(a,lo,p,comp,tr); lo=p; }
+        else { quick(a,p,hi,comp,tr); hi=p; }
+    }
+    small_sort(a,lo,hi,comp,tr);
+}
+
+}
+
+template<class RandomIt, class Compare, class Trace>
+void quick_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    detail::quick(first,0,last-first,comp,tr);
+}
+
+template<class RandomIt, class Compare>
+void quick_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    quick_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void quick_sort(RandomIt first, RandomIt last)
+{
+    quick_sort(first,last,std::less<>());
+}
+
+//Быстрая сортировка с блочным разбиением без ветвлений по данным
+template<class RandomIt, class Compare, class Trace>
+void block_quick_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    detail::block_quick(first,0,last-first,comp,tr);
+}
+
+template<class RandomIt, class Compare>
+void block_quick_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    block_quick_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void block_quick_sort(RandomIt first, RandomIt last)
+{
+    block_quick_sort(first,last,std::less<>());
+}
+
+}
+
+#endif //SORT_QUICK_H
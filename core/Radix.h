@@ -0,0 +1,183 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_RADIX_H
+#define SORT_RADIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Trace.h"
+#include "Parallel.h"
+#include "Network.h"
+
+namespace sortcore {
+
+//Отображение ключа в беззнаковое целое с тем же порядком
+template<class T, class Enable=void>
+struct RadixKey;
+
+template<class T>
+struct RadixKey<T,typename std::enable_if<std::is_integral<T>::value && !std::is_same<T,bool>::value>::type>{
+    typedef typename std::make_unsigned<T>::type type;
+    static type key(T v) {
+        const type flip=std::is_signed<T>::value ? type(type(1)<<(sizeof(T)*8-1)) : type(0);
+        return type(v)^flip;
+    }
+};
+
+//IEEE 754: у отрицательных инвертируются все биты, у положительных -- знаковый
+template<class T>
+struct RadixKey<T,typename std::enable_if<std::is_floating_point<T>::value>::type>{
+    static_assert(sizeof(T)==4 || sizeof(T)==8, "radix_sort supports float and double");
+    typedef typename std::conditional<sizeof(T)==4,std::uint32_t,std::uint64_t>::type type;
+    static type key(T v) {
+        type b;
+        std::memcpy(&b,&v,sizeof(b));
+        const type sign=type(1)<<(sizeof(T)*8-1);
+        return b&sign ? ~b : b|sign;
+    }
+};
+
+namespace detail {
+
+//Меньше этого числа элементов на поток дополнительные потоки не запускаются
+const std::ptrdiff_t radix_grain=1<<16;
+//Размер буфера записи для одного значения разряда -- одна кэш-линия
+const std::size_t radix_line=64;
+
+template<class T>
+struct RadixLess{
+    bool operator()(const T &x, const T &y) const { return RadixKey<T>::key(x)<RadixKey<T>::key(y); }
+};
+
+//Один проход LSD: src[0..n) -> dst[0..n) по разряду (key>>shift)&mask.
+//Каждый поток считает гистограмму своего куска; смещения раскладываются в
+//порядке (разряд, поток), поэтому проход устойчив. При малом основании
+//элементы копятся в буферах по кэш-линии на разряд и выписываются целиком,
+//что избавляет от промахов записи в 2^bits разбросанных мест.
+//Возвращает false, если у всех элементов один и тот же разряд.
+template<class T>
+bool radix_pass(const T *src, T *dst, std::ptrdiff_t n, unsigned shift, unsigned bits, unsigned p,
+                std::vector<std::vector<std::size_t>> &hist)
+{
+    typedef RadixKey<T> K;
+    const std::size_t R=std::size_t(1)<<bits;
+    const typename K::type mask=typename K::type(R-1);
+    auto chunk=[&](unsigned t) { return n*(std::ptrdiff_t)t/(std::ptrdiff_t)p; };
+    fork_join(p,[&](unsigned t) {
+        std::vector<std::size_t> &h=hist[t];
+        std::fill(h.begin(),h.end(),0);
+        for(std::ptrdiff_t i=chunk(t);i<chunk(t+1);i++) h[(K::key(src[i])>>shift)&mask]++;
+    });
+    std::size_t sum=0;
+    for(std::size_t d=0;d<R;d++)
+    {
+        std::size_t total=0;
+        for(unsigned t=0;t<p;t++) total+=hist[t][d];
+        if(total==(std::size_t)n) return false;
+        for(unsigned t=0;t<p;t++)
+        {
+            std::size_t c=hist[t][d];
+            hist[t][d]=sum;
+            sum+=c;
+        }
+    }
+    const std::size_t B=std::max<std::size_t>(1,radix_line/sizeof(T));
+    const bool combine=bits<=11 && std::is_trivially_copyable<T>::value;
+    fork_join(p,[&](unsigned t) {
+        std::vector<std::size_t> &off=hist[t];
+        std::ptrdiff_t lo=chunk(t), hi=chunk(t+1);
+        if(!combine)
+        {
+            for(std::ptrdiff_t i=lo;i<hi;i++) dst[off[(K::key(src[i])>>shift)&mask]++]=src[i];
+            return;
+        }
+        std::vector<T> wc(R*B);
+        std::vector<unsigned char> fill(R,0);
+        for(std::ptrdiff_t i=lo;i<hi;i++)
+        {
+            std::size_t d=(K::key(src[i])>>shift)&mask;
+            wc[d*B+fill[d]]=src[i];
+            if(++fill[d]==B)
+            {
+                std::memcpy(dst+off[d],&wc[d*B],B*sizeof(T));
+                off[d]+=B;
+                fill[d]=0;
+            }
+        }
+        for(std::size_t d=0;d<R;d++)
+            if(fill[d])
+            {
+                std::memcpy(dst+off[d],&wc[d*B],fill[d]*sizeof(T));
+                off[d]+=fill[d];
+            }
+    });
+    return true;
+}
+
+}
+
+//LSD-сортировка для целых (знаковых и беззнаковых) и float/double ключей на
+//непрерывном диапазоне. bits -- ширина разряда (8, 11 или 16), threads --
+//число потоков, 0 -- по числу ядер. Проходы, в которых у всех элементов
+//одинаковый разряд, пропускаются. Без трассировки массивы меняются ролями
+//между проходами; с трассировкой каждый проход записывается обратно в
+//исходный массив, чтобы окно видело промежуточные состояния.
+template<class RandomIt, class Trace>
+void radix_sort(RandomIt first, RandomIt last, Trace &tr, unsigned bits=8, unsigned threads=0)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef RadixKey<T> K;
+    std::ptrdiff_t n=last-first;
+    if(n<2) return;
+    //на коротком входе проходы по разрядам не окупают буфер и гистограммы.
+    //Сеть неустойчива, но берётся только для чисел, где равные ключи --
+    //равные значения; записи досортировываются устойчивыми вставками.
+    if(n<=(std::ptrdiff_t)detail::network_max)
+    {
+        detail::RadixLess<T> comp;
+        detail::small_sort(first,0,n,comp,tr);
+        return;
+    }
+    bits=std::min(std::max(bits,1u),16u);
+    unsigned p=(unsigned)std::max<std::ptrdiff_t>(1,std::min<std::ptrdiff_t>(threads_or_default(threads),n/detail::radix_grain));
+    std::vector<std::vector<std::size_t>> hist(p,std::vector<std::size_t>(std::size_t(1)<<bits));
+    T *a=&*first;
+    std::vector<T> buf(n);
+    T *src=a, *dst=buf.data();
+    for(unsigned shift=0;shift<sizeof(typename K::type)*8;shift+=bits)
+    {
+        if(!detail::radix_pass(src,dst,n,shift,bits,p,hist)) continue;
+        if(Trace::enabled)
+        {
+            for(std::ptrdiff_t i=0;i<n;i++)
+            {
+                a[i]=dst[i];
+                tr.write(i,a[i]);
+            }
+        }
+        else std::swap(src,dst);
+    }
+    if(src!=a) detail::fork_join(p,[&](unsigned t) {
+        std::copy(src+n*(std::ptrdiff_t)t/(std::ptrdiff_t)p,src+n*(std::ptrdiff_t)(t+1)/(std::ptrdiff_t)p,
+                  a+n*(std::ptrdiff_t)t/(std::ptrdiff_t)p);
+    });
+}
+
+template<class RandomIt>
+void radix_sort(RandomIt first, RandomIt last, unsigned bits=8, unsigned threads=0)
+{
+    NoTrace tr;
+    radix_sort(first,last,tr,bits,threads);
+}
+
+}
+
+#endif //SORT_RADIX_H
@@ -0,0 +1,223 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_SAMPLESORT_H
+#define SORT_SAMPLESORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Trace.h"
+#include "Parallel.h"
+#include "Pdq.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Отрезки короче этого сортируются сразу pdqsort
+const std::ptrdiff_t sample_grain=1<<14;
+//Не больше 2^8 корзин: номер корзины (с корзинами равных) помещается в uint16_t,
+//а 256 потоков записи ещё не переполняют буферы записи процессора
+const unsigned sample_log_buckets=8;
+//Средний размер корзины, к которому стремится выбор их числа
+const std::ptrdiff_t sample_bucket_size=1<<12;
+//Сколько элементов выборки приходится на одну корзину
+const unsigned sample_oversampling=16;
+
+//Классификатор по k-1 разделителю, k -- степень двойки. Разделители лежат в
+//неявном дереве поиска (корень в tree[1], дети узла j -- 2j и 2j+1), поэтому
+//спуск -- это log k шагов j=2j+(разделитель<x) без ветвлений. Если среди
+//разделителей есть равные, у каждого разделителя появляется своя корзина
+//равных ему элементов: такие корзины уже упорядочены и не сортируются.
+template<class T, class Compare>
+class Classifier{
+    std::vector<T> tree, split;
+    unsigned log_k, k;
+    bool equal;
+    Compare &comp;
+
+    void build(std::size_t node, std::size_t lo, std::size_t hi) {
+        if(lo>=hi) return;
+        std::size_t mid=lo+(hi-lo)/2;
+        tree[node]=split[mid];
+        build(2*node,lo,mid);
+        build(2*node+1,mid+1,hi);
+    }
+public:
+    //sample -- упорядоченная выборка из (k*oversampling-1) элементов
+    Classifier(const std::vector<T> &sample, unsigned log_k, Compare &comp)
+            : log_k(log_k), k(1u<<log_k), equal(false), comp(comp) {
+        for(unsigned i=1;i<k;i++) split.push_back(sample[(std::size_t)i*sample_oversampling-1]);
+        for(unsigned i=1;i+1<k;i++) if(!comp(split[i-1],split[i])) equal=true;
+        tree.resize(k);
+        build(1,0,k-1);
+    }
+    unsigned buckets() const { return equal ? 2*k : k; }
+    //Корзина равных разделителю -- нечётная, её не нужно сортировать
+    bool sorted(unsigned b) const { return equal && (b&1); }
+    //Корзина b (без равных) содержит split[b-1] < x <= split[b]
+    unsigned operator()(const T &x) const {
+        std::size_t j=1;
+        for(unsigned l=0;l<log_k;l++) j=2*j+(comp(tree[j],x) ? 1 : 0);
+        unsigned b=unsigned(j-k);
+        if(equal) b=2*b+(b+1<k && !comp(x,split[b]) ? 1 : 0);
+        return b;
+    }
+    //Классификация восьми элементов за раз: спуски независимы, и процессор
+    //ведёт их одновременно, а не ждёт загрузки узла каждого по очереди
+    template<class RandomIt>
+    void classify(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, std::uint16_t *out, std::size_t *hist) const {
+        const int U=8;
+        std::ptrdiff_t i=lo;
+        for(;i+U<=hi;i+=U)
+        {
+            std::size_t j[U];
+            for(int u=0;u<U;u++) j[u]=1;
+            for(unsigned l=0;l<log_k;l++)
+                for(int u=0;u<U;u++) j[u]=2*j[u]+(comp(tree[j[u]],a[i+u]) ? 1 : 0);
+            for(int u=0;u<U;u++)
+            {
+                unsigned b=unsigned(j[u]-k);
+                if(equal) b=2*b+(b+1<k && !comp(a[i+u],split[b]) ? 1 : 0);
+                out[i+u]=(std::uint16_t)b;
+                hist[b]++;
+            }
+        }
+        for(;i<hi;i++)
+        {
+            out[i]=(std::uint16_t)(*this)(a[i]);
+            hist[out[i]]++;
+        }
+    }
+};
+
+//log2 числа корзин для n элементов: от 2 до 2^sample_log_buckets
+inline unsigned sample_log_k(std::ptrdiff_t n)
+{
+    unsigned l=1;
+    while(l<sample_log_buckets && (n>>(l+1))>=sample_bucket_size) l++;
+    return l;
+}
+
+template<class RandomIt, class Compare, class Trace>
+void sample_sort(RandomIt a, std::ptrdiff_t n, Compare &comp, Trace &tr, unsigned p)
+{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    if(n<sample_grain)
+    {
+        pdq(a,0,n,comp,tr,log2_floor(n),true);
+        return;
+    }
+    //Выборка: по элементу из равных долей массива со случайным сдвигом внутри доли
+    unsigned log_k=sample_log_k(n);
+    std::size_t m=((std::size_t)sample_oversampling<<log_k)-1;
+    std::vector<T> sample;
+    sample.reserve(m);
+    std::uint64_t x=0x9E3779B97F4A7C15ull^(std::uint64_t)n;
+    std::ptrdiff_t step=n/(std::ptrdiff_t)m;
+    for(std::size_t i=0;i<m;i++)
+    {
+        x^=x<<13; x^=x>>7; x^=x<<17;
+        sample.push_back(a[(std::ptrdiff_t)i*step+(std::ptrdiff_t)(x%(std::uint64_t)step)]);
+    }
+    pdq_sort(sample.begin(),sample.end(),comp);
+    Classifier<T,Compare> cls(sample,log_k,comp);
+    const unsigned B=cls.buckets();
+
+    //Проход 1: каждый поток классифицирует свой кусок, запоминая корзины
+    std::vector<std::uint16_t> oracle(n);
+    std::vector<std::vector<std::size_t>> hist(p,std::vector<std::size_t>(B,0));
+    auto chunk=[&](unsigned t) { return n*(std::ptrdiff_t)t/(std::ptrdiff_t)p; };
+    fork_join(p,[&](unsigned t) {
+        cls.classify(a,chunk(t),chunk(t+1),oracle.data(),hist[t].data());
+    });
+    //Смещения в порядке (корзина, поток): куски потоков не пересекаются
+    std::vector<std::size_t> start(B+1);
+    std::size_t sum=0;
+    for(unsigned b=0;b<B;b++)
+    {
+        start[b]=sum;
+        for(unsigned t=0;t<p;t++)
+        {
+            std::size_t c=hist[t][b];
+            hist[t][b]=sum;
+            sum+=c;
+        }
+    }
+    start[B]=sum;
+    //Проход 2: единственное перемещение данных -- раскладка по корзинам в буфер
+    std::vector<T> buf(n);
+    fork_join(p,[&](unsigned t) {
+        std::size_t *off=hist[t].data();
+        for(std::ptrdiff_t i=chunk(t);i<chunk(t+1);i++) buf[off[oracle[i]]++]=a[i];
+    });
+    std::vector<std::uint16_t>().swap(oracle);
+    //Корзины разбирают потоки по очереди, крупные вперёд. Корзина копируется
+    //обратно и сразу сортируется, пока она в кэше.
+    std::vector<unsigned> order(B);
+    for(unsigned b=0;b<B;b++) order[b]=b;
+    std::sort(order.begin(),order.end(),[&](unsigned l, unsigned r) {
+        return start[l+1]-start[l]>start[r+1]-start[r];
+    });
+    std::atomic<unsigned> next(0);
+    fork_join(p,[&](unsigned) {
+        for(unsigned i;(i=next.fetch_add(1))<B;)
+        {
+            unsigned b=order[i];
+            std::ptrdiff_t lo=(std::ptrdiff_t)start[b], hi=(std::ptrdiff_t)start[b+1];
+            for(std::ptrdiff_t j=lo;j<hi;j++)
+            {
+                a[j]=buf[j];
+                tr.write(j,a[j]);
+            }
+            if(hi-lo>1 && !cls.sorted(b)) pdq(a,lo,hi,comp,tr,log2_floor(hi-lo),true);
+        }
+    });
+}
+
+}
+
+//Параллельная сортировка выборкой (sample sort). Из выборки с запасом
+//(sample_oversampling элементов на корзину) берутся разделители, каждый поток
+//классифицирует свой кусок деревом поиска без ветвлений, затем за один проход
+//раскладывает его по корзинам, и корзины сортируются pdqsort параллельно.
+//В отличие от parallel_quick_sort данные перемещаются один раз, а не на
+//каждом уровне рекурсии, что и масштабируется на машинах с многими каналами
+//памяти. Нужен буфер на n элементов и 2 байта на элемент для номеров корзин.
+//threads -- число потоков, 0 -- по числу ядер.
+template<class RandomIt, class Compare, class Trace>
+void sample_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr, unsigned threads=0)
+{
+    std::ptrdiff_t n=last-first;
+    if(n<2) return;
+    unsigned p=(unsigned)std::max<std::ptrdiff_t>(1,std::min<std::ptrdiff_t>(threads_or_default(threads),
+                                                                              n/detail::sample_grain));
+    if(Trace::enabled && p>1)
+    {
+        LockedTrace<Trace> lt(tr);
+        detail::sample_sort(first,n,comp,lt,p);
+    }
+    else detail::sample_sort(first,n,comp,tr,p);
+}
+
+template<class RandomIt, class Compare>
+void sample_sort(RandomIt first, RandomIt last, Compare comp, unsigned threads=0)
+{
+    NoTrace tr;
+    sample_sort(first,last,comp,tr,threads);
+}
+
+template<class RandomIt>
+void sample_sort(RandomIt first, RandomIt last)
+{
+    sample_sort(first,last,std::less<>());
+}
+
+}
+
+#endif //SORT_SAMPLESORT_H
@@ -0,0 +1,180 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_SELECT_H
+#define SORT_SELECT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "Trace.h"
+#include "Insertion.h"
+#include "Network.h"
+#include "Quick.h"
+#include "Heap.h"
+#include "Pdq.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//При k не больше n/heap_select_ratio частичная сортировка идёт кучей: почти
+//каждый элемент отсеивается одним сравнением с вершиной, и это быстрее
+//разбиений, которые переставляют весь массив
+const std::ptrdiff_t heap_select_ratio=64;
+
+//Отбор кучей: в a[lo..mid) собираются mid-lo наименьших из a[lo..hi),
+//наибольший из них -- в a[lo]. O(n log k), на случай плохих разбиений.
+template<class RandomIt, class Compare, class Trace>
+void heap_select(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t mid, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    std::ptrdiff_t k=mid-lo;
+    for(std::ptrdiff_t i=k/2-1;i>=0;i--) sift_down(a,lo,i,k,comp,tr);
+    for(std::ptrdiff_t i=mid;i<hi;i++)
+        if(less_at(a,i,lo,comp,tr))
+        {
+            swap_at(a,i,lo,tr);
+            sift_down(a,lo,0,k,comp,tr);
+        }
+}
+
+//Интроселект: разбиение Хоара по медиане трёх и спуск только в ту часть,
+//где лежит nth. Ожидаемо O(n); после 2*log2(n) разбиений без заметного
+//сужения -- отбор кучей, так что худший случай O(n log n).
+template<class RandomIt, class Compare, class Trace>
+void select(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t nth, std::ptrdiff_t hi, Compare &comp, Trace &tr)
+{
+    int budget=2*log2_floor(hi-lo);
+    while(hi-lo>insertion_threshold)
+    {
+        if(budget--==0)
+        {
+            heap_select(a,lo,nth+1,hi,comp,tr);
+            if(nth!=lo) swap_at(a,lo,nth,tr);
+            return;
+        }
+        std::ptrdiff_t p=hoare_partition(a,lo,hi,comp,tr);
+        if(nth<p) hi=p;
+        else lo=p;
+    }
+    small_sort(a,lo,hi,comp,tr);
+}
+
+}
+
+//Ставит на место nth элемент, который стоял бы там после сортировки; слева
+//от него -- не большие, справа -- не меньшие (как std::nth_element)
+template<class RandomIt, class Compare, class Trace>
+void select_nth(RandomIt first, RandomIt nth, RandomIt last, Compare comp, Trace &tr)
+{
+    if(nth==last) return;
+    detail::select(first,0,nth-first,last-first,comp,tr);
+}
+
+template<class RandomIt, class Compare>
+void select_nth(RandomIt first, RandomIt nth, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    select_nth(first,nth,last,comp,tr);
+}
+
+template<class RandomIt>
+void select_nth(RandomIt first, RandomIt nth, RandomIt last)
+{
+    select_nth(first,nth,last,std::less<>());
+}
+
+//Частичная сортировка: первые k мест занимают k наименьших по порядку,
+//остальное -- в произвольном порядке. Малые k отбираются кучей, остальные --
+//интроселектом, затем O(k log k) на сортировку отобранного.
+template<class RandomIt, class Compare, class Trace>
+void sort_first_k(RandomIt first, RandomIt last, std::size_t k, Compare comp, Trace &tr)
+{
+    std::ptrdiff_t n=last-first, m=(std::ptrdiff_t)std::min<std::size_t>(k,n);
+    if(m==0) return;
+    if(m==n) {
+        detail::pdq(first,0,n,comp,tr,detail::log2_floor(n),true);
+        return;
+    }
+    if(m<=n/detail::heap_select_ratio) {
+        detail::heap_select(first,0,m,n,comp,tr);
+        detail::pdq(first,0,m,comp,tr,detail::log2_floor(m),true);
+        return;
+    }
+    //после отбора a[m-1] уже на месте, и сортировать остаётся левее него
+    detail::select(first,0,m-1,n,comp,tr);
+    detail::pdq(first,0,m-1,comp,tr,detail::log2_floor(m),true);
+}
+
+template<class RandomIt, class Compare>
+void sort_first_k(RandomIt first, RandomIt last, std::size_t k, Compare comp)
+{
+    NoTrace tr;
+    sort_first_k(first,last,k,comp,tr);
+}
+
+template<class RandomIt>
+void sort_first_k(RandomIt first, RandomIt last, std::size_t k)
+{
+    sort_first_k(first,last,k,std::less<>());
+}
+
+//k наименьших по comp из потока, поданного любыми кусками, в O(k) памяти;
+//для k наибольших -- std::greater. Держится max-куча из k лучших: новый
+//элемент сравнивается только с её вершиной, так что на длинном потоке почти
+//все элементы отсеиваются одним сравнением.
+template<class T, class Compare=std::less<>>
+class TopK{
+    std::vector<T> heap;
+    std::size_t k;
+    Compare comp;
+    void sift_up(std::ptrdiff_t i)
+    {
+        T v=std::move(heap[i]);
+        while(i>0 && comp(heap[(i-1)/2],v))
+        {
+            heap[i]=std::move(heap[(i-1)/2]);
+            i=(i-1)/2;
+        }
+        heap[i]=std::move(v);
+    }
+public:
+    explicit TopK(std::size_t k, Compare comp=Compare()) : k(k), comp(comp) { heap.reserve(k); }
+    void push(const T &x)
+    {
+        if(heap.size()<k)
+        {
+            heap.push_back(x);
+            sift_up((std::ptrdiff_t)heap.size()-1);
+        }
+        else if(k>0 && comp(x,heap[0]))
+        {
+            NoTrace tr;
+            heap[0]=x;
+            detail::sift_down(heap.begin(),0,0,(std::ptrdiff_t)k,comp,tr);
+        }
+    }
+    template<class It>
+    void push(It first, It last)
+    {
+        for(;first!=last;++first) push(*first);
+    }
+    std::size_t size() const { return heap.size(); }
+    //Худший из отобранных: порог, который должен побить новый элемент
+    const T &threshold() const { return heap.front(); }
+    //Отобранные по порядку comp
+    std::vector<T> sorted() const
+    {
+        std::vector<T> out(heap);
+        pdq_sort(out.begin(),out.end(),comp);
+        return out;
+    }
+};
+
+}
+
+#endif //SORT_SELECT_H
@@ -0,0 +1,317 @@
+//
+// Created by andrew on 18.10.26.
+//
+//Проверки ядер, которые легко сломать незаметно, для ctest:
+//  selftest simd         -- simd_sort, batch_sort и batch_sort_offsets против
+//                           std::sort на уровне из SORT_SIMD (ctest гоняет
+//                           scalar, sse42 и лучший доступный)
+//  selftest network      -- network_sort<N> по принципу нулей и единиц
+//  selftest distributed  -- distributed_sort на 1, 3 и 5 узлах
+//  selftest argsort      -- argsort, sort_by_key и apply_permutation против
+//                           std::stable_sort: на равных ключах порядок исходный
+//  selftest parse        -- parse_ints на границах int: крайние значения
+//                           разбираются, всё за ними -- std::out_of_range
+//Код возврата 0 -- всё совпало, иначе в stderr первое расхождение.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Argsort.h"
+#include "Distributed.h"
+#include "Ingest.h"
+#include "Network.h"
+#include "Simd.h"
+
+using namespace sortcore;
+
+namespace {
+
+const std::size_t sizes[]={0,1,2,3,4,5,7,8,9,15,16,17,31,32,33,63,64,65,100,127,128,129,
+                           255,256,257,1000,4095,4096,4097,100000};
+
+enum class Input{Random, FewUnique, TopHeavy, Sorted, Reverse};
+
+const Input inputs[]={Input::Random, Input::FewUnique, Input::TopHeavy, Input::Sorted, Input::Reverse};
+
+const char *id(Input k)
+{
+    switch(k)
+    {
+        case Input::Random: return "random";
+        case Input::FewUnique: return "few_unique";
+        case Input::TopHeavy: return "top_heavy";
+        case Input::Sorted: return "sorted";
+        case Input::Reverse: return "reverse";
+    }
+    return "";
+}
+
+//TopHeavy -- половина наибольших и немного наименьших значений: ими же ядра
+//дополняют неполные регистры
+template<class T>
+T value(std::mt19937_64 &g, Input k)
+{
+    typedef std::numeric_limits<T> L;
+    const T top=L::has_infinity ? L::infinity() : L::max(), bottom=L::has_infinity ? -L::infinity() : L::min();
+    switch(k)
+    {
+        case Input::FewUnique: return T(g()%4);
+        case Input::TopHeavy: {
+            std::uint64_t r=g()%16;
+            if(r<8) return top;
+            if(r==8) return bottom;
+            return T(std::int32_t(g()));
+        }
+        default: return T(std::int64_t(g()));
+    }
+}
+
+template<class T>
+std::vector<T> input(std::mt19937_64 &g, std::size_t n, Input k)
+{
+    std::vector<T> v(n);
+    for(auto &x : v) x=value<T>(g,k);
+    if(k==Input::Sorted) std::sort(v.begin(),v.end());
+    if(k==Input::Reverse) std::sort(v.rbegin(),v.rend());
+    return v;
+}
+
+template<class T>
+bool check_simd(std::mt19937_64 &g, const char *type)
+{
+    for(std::size_t n : sizes)
+        for(Input k : inputs)
+        {
+            std::vector<T> v=input<T>(g,n,k), w=v;
+            std::sort(w.begin(),w.end());
+            simd_sort(v.data(),v.data()+n);
+            if(v!=w)
+            {
+                std::fprintf(stderr,"simd_sort<%s>: n=%zu %s\n",type,n,id(k));
+                return false;
+            }
+        }
+    return true;
+}
+
+template<class T>
+bool check_batch(std::mt19937_64 &g, const char *type)
+{
+    const std::size_t counts[]={1,7,8,9,100,5000};
+    for(std::size_t len=0;len<=batch_max+6;len++)
+        for(std::size_t count : counts)
+            for(Input k : inputs)
+            {
+                std::vector<T> v=input<T>(g,count*len,k), w=v;
+                for(std::size_t i=0;i<count;i++) std::sort(w.begin()+i*len,w.begin()+(i+1)*len);
+                batch_sort(v.data(),count,len,3);
+                if(v!=w)
+                {
+                    std::fprintf(stderr,"batch_sort<%s>: len=%zu count=%zu %s\n",type,len,count,id(k));
+                    return false;
+                }
+            }
+    for(std::size_t longest : {3,20,65,200})
+        for(Input k : inputs)
+        {
+            std::vector<std::size_t> off(10001);
+            for(std::size_t i=0;i+1<off.size();i++) off[i+1]=off[i]+g()%longest;
+            std::vector<T> v=input<T>(g,off.back(),k), w=v;
+            for(std::size_t i=0;i+1<off.size();i++) std::sort(w.begin()+off[i],w.begin()+off[i+1]);
+            batch_sort_offsets(v.data(),off.data(),off.size()-1,2);
+            if(v!=w)
+            {
+                std::fprintf(stderr,"batch_sort_offsets<%s>: longest=%zu %s\n",type,longest,id(k));
+                return false;
+            }
+        }
+    return true;
+}
+
+int simd()
+{
+    std::printf("SIMD: %s\n",id(simd_level()));
+    std::mt19937_64 g(1);
+    bool ok=check_simd<std::int32_t>(g,"int32") && check_simd<std::int64_t>(g,"int64") && check_simd<float>(g,"float") &&
+            check_batch<std::int32_t>(g,"int32") && check_batch<float>(g,"float");
+    return ok ? 0 : 1;
+}
+
+//Сеть сортирует всё, если сортирует все входы из нулей и единиц (Кнут,
+//5.3.4): до exhaustive элементов -- все 2^N входов, дальше -- случайные
+const std::size_t exhaustive=20;
+const std::size_t random_inputs=1<<16;
+
+template<std::size_t N>
+bool check_network(std::mt19937_64 &g)
+{
+    std::uint64_t total=N<=exhaustive ? std::uint64_t(1)<<N : random_inputs;
+    for(std::uint64_t m=0;m<total;m++)
+    {
+        std::uint64_t bits=N<=exhaustive ? m : g();
+        int v[N ? N : 1];
+        std::size_t ones=0;
+        for(std::size_t i=0;i<N;i++) ones+=v[i]=int((bits>>i)&1);
+        network_sort<N>(v);
+        for(std::size_t i=0;i<N;i++)
+            if(v[i]!=(i>=N-ones))
+            {
+                std::fprintf(stderr,"network_sort<%zu>: вход %llx\n",N,(unsigned long long)bits);
+                return false;
+            }
+    }
+    return true;
+}
+
+template<std::size_t... N>
+bool check_networks(std::mt19937_64 &g, std::index_sequence<N...>)
+{
+    bool ok=true;
+    int all[]={0,(ok=ok && check_network<N>(g),0)...};
+    (void)all;
+    return ok;
+}
+
+int network()
+{
+    std::mt19937_64 g(2);
+    return check_networks(g,std::make_index_sequence<detail::network_max+1>()) ? 0 : 1;
+}
+
+int distributed()
+{
+    std::mt19937_64 g(3);
+    const std::size_t n[]={0,1,2,7,1000,100000};
+    for(unsigned workers : {1u,3u,5u})
+        for(std::size_t m : n)
+            for(Input k : inputs)
+            {
+                std::vector<int> v=input<int>(g,m,k), w=v;
+                std::sort(w.begin(),w.end());
+                DistributedOptions opt;
+                opt.workers=workers;
+                distributed_sort(v,opt);
+                if(v!=w)
+                {
+                    std::fprintf(stderr,"distributed_sort: workers=%u n=%zu %s\n",workers,m,id(k));
+                    return 1;
+                }
+            }
+    return 0;
+}
+
+//Эталон: номера, устойчиво упорядоченные по ключу
+template<class Key, class Compare>
+std::vector<std::uint32_t> stable_order(const std::vector<Key> &k, Compare comp)
+{
+    std::vector<std::uint32_t> perm(k.size());
+    std::iota(perm.begin(),perm.end(),0u);
+    std::stable_sort(perm.begin(),perm.end(),[&](std::uint32_t x, std::uint32_t y) { return comp(k[x],k[y]); });
+    return perm;
+}
+
+template<class Key>
+bool check_argsort(const std::vector<Key> &k, const char *type)
+{
+    //целое третьим аргументом -- число потоков, а не сравнение
+    if(argsort(k.begin(),k.end(),4)!=stable_order(k,std::less<>()) ||
+       argsort(k.begin(),k.end(),std::greater<>())!=stable_order(k,std::greater<>()))
+    {
+        std::fprintf(stderr,"argsort<%s>: n=%zu\n",type,k.size());
+        return false;
+    }
+    std::vector<Keyed<Key,std::uint32_t>> r(k.size());
+    for(std::size_t i=0;i<k.size();i++) r[i]={k[i],std::uint32_t(i)};
+    sort_by_key(r.begin(),r.end(),2);
+    std::vector<std::uint32_t> perm=stable_order(k,std::less<>());
+    for(std::size_t i=0;i<r.size();i++)
+        if(r[i].payload!=perm[i])
+        {
+            std::fprintf(stderr,"sort_by_key<%s>: n=%zu\n",type,k.size());
+            return false;
+        }
+    std::vector<Key> out(k.size()), w=k;
+    apply_permutation(perm,k.begin(),out.begin(),3);
+    std::stable_sort(w.begin(),w.end());
+    if(out!=w)
+    {
+        std::fprintf(stderr,"apply_permutation<%s>: n=%zu\n",type,k.size());
+        return false;
+    }
+    return true;
+}
+
+int argsorts()
+{
+    std::mt19937_64 g(4);
+    const char *words[]={"b","a","c","ab"};
+    for(std::size_t n : sizes)
+        for(Input k : inputs)
+        {
+            std::vector<int> ints=input<int>(g,n,k);
+            std::vector<std::uint64_t> wide(n);
+            std::vector<std::string> text(n);
+            for(std::size_t i=0;i<n;i++)
+            {
+                wide[i]=std::uint64_t(ints[i])<<20;
+                text[i]=k==Input::FewUnique ? words[g()%4] : std::to_string(ints[i]);
+            }
+            if(!check_argsort(ints,"int") || !check_argsort(wide,"uint64") || !check_argsort(text,"string"))
+                return 1;
+        }
+    return 0;
+}
+
+//Длинные числа проходят и через восьмибайтовый путь, и через хвост по цифре
+int parse()
+{
+    const std::string edge="2147483647 -2147483648 0 -0 -x 1,-2;000000000000000000000042";
+    std::vector<int> v=parse_ints(edge.data(),edge.data()+edge.size(),2),
+                     w={2147483647,-2147483648,0,0,1,-2,42};
+    if(v!=w)
+    {
+        std::fprintf(stderr,"parse_ints: %s\n",edge.c_str());
+        return 1;
+    }
+    const char *out[]={"2147483648","-2147483649","4294967297","-4294967295",
+                       "99999999999999999999999","1 2 -99999999999999999999999999999 3"};
+    for(const char *s : out)
+        try {
+            parse_ints(s,s+std::strlen(s),2);
+            std::fprintf(stderr,"parse_ints: %s -- нет out_of_range\n",s);
+            return 1;
+        }
+        catch(const std::out_of_range&) {}
+    return 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    const char *what=argc>1 ? argv[1] : "";
+    try {
+        if(std::strcmp(what,"simd")==0) return simd();
+        if(std::strcmp(what,"network")==0) return network();
+        if(std::strcmp(what,"distributed")==0) return distributed();
+        if(std::strcmp(what,"argsort")==0) return argsorts();
+        if(std::strcmp(what,"parse")==0) return parse();
+    }
+    catch(const std::exception &e) {
+        std::fprintf(stderr,"%s\n",e.what());
+        return 1;
+    }
+    std::fprintf(stderr,"usage: %s simd|network|distributed|argsort|parse\n",argv[0]);
+    return 2;
+}
@@ -0,0 +1,155 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_SHELL_H
+#define SORT_SHELL_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include "Trace.h"
+#include "Insertion.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//h-сортировка вставками a[lo..hi) с шагом h
+template<class RandomIt, class Compare, class Trace>
+void hsort(RandomIt a, std::ptrdiff_t lo, std::ptrdiff_t hi, std::ptrdiff_t h, Compare &comp, Trace &tr)
+{
+    for(std::ptrdiff_t i=lo+h;i<hi;i++)
+    {
+        auto v=std::move(a[i]);
+        std::ptrdiff_t j=i;
+        while(j-h>=lo)
+        {
+            tr.compare(i,j-h);
+            if(!comp(v,a[j-h])) break;
+            a[j]=std::move(a[j-h]);
+            tr.write(j,a[j]);
+            j-=h;
+        }
+        a[j]=std::move(v);
+        if(j!=i) tr.write(j,a[j]);
+    }
+}
+
+}
+
+//Политики шагов: fill(n, gaps) пишет возрастающие шаги меньше n, начиная
+//с 1, и возвращает их число (не больше max_gaps). Ядро инстанцируется для
+//каждой политики отдельно.
+const int max_gaps=64;
+
+//n/2, n/4, ..., 1 -- исходная последовательность Шелла, O(n^2) в худшем случае
+struct ShellGaps{
+    static int fill(std::ptrdiff_t n, std::ptrdiff_t *gaps)
+    {
+        int g=0;
+        for(std::ptrdiff_t h=n/2;h>0;h/=2) gaps[g++]=h;
+        if(g==0) gaps[g++]=1;
+        std::reverse(gaps,gaps+g);
+        return g;
+    }
+};
+
+//(3^k-1)/2 не больше n/3 -- Кнут, O(n^1.5)
+struct KnuthGaps{
+    static int fill(std::ptrdiff_t n, std::ptrdiff_t *gaps)
+    {
+        int g=0;
+        gaps[g++]=1;
+        while(gaps[g-1]*3+1<=n/3) { gaps[g]=gaps[g-1]*3+1; g++; }
+        return g;
+    }
+};
+
+//1, 4^k + 3*2^(k-1) + 1 -- Седжвик 1986, O(n^4/3)
+struct SedgewickGaps{
+    static int fill(std::ptrdiff_t n, std::ptrdiff_t *gaps)
+    {
+        int g=0;
+        gaps[g++]=1;
+        for(int k=1;k<31;k++)
+        {
+            std::ptrdiff_t h=(std::ptrdiff_t(1)<<(2*k))+3*(std::ptrdiff_t(1)<<(k-1))+1;
+            if(h>=n) break;
+            gaps[g++]=h;
+        }
+        return g;
+    }
+};
+
+//ceil((9^k-4^k)/(5*4^(k-1))) -- Токуда
+struct TokudaGaps{
+    static int fill(std::ptrdiff_t n, std::ptrdiff_t *gaps)
+    {
+        int g=0;
+        gaps[g++]=1;
+        for(double p=2.25*2.25;g<max_gaps;p*=2.25)
+        {
+            std::ptrdiff_t h=(std::ptrdiff_t)std::ceil((p*4-4)/5);
+            if(h>=n) break;
+            gaps[g++]=h;
+        }
+        return g;
+    }
+};
+
+//Эмпирическая последовательность Циуры, продолженная умножением на 2.25
+struct CiuraGaps{
+    static int fill(std::ptrdiff_t n, std::ptrdiff_t *gaps)
+    {
+        static const std::ptrdiff_t ciura[]={1,4,10,23,57,132,301,701,1750};
+        int g=0;
+        for(auto h : ciura)
+            if(h<n || g==0) gaps[g++]=h;
+        while(g>=9 && gaps[g-1]*9/4<n) { gaps[g]=gaps[g-1]*9/4; g++; }
+        return g;
+    }
+};
+
+//Своя последовательность, заданная возрастающими шагами: FixedGaps<1,5,19,41>
+template<std::ptrdiff_t... H>
+struct FixedGaps{
+    static int fill(std::ptrdiff_t n, std::ptrdiff_t *gaps)
+    {
+        static const std::ptrdiff_t fixed[]={H...};
+        int g=0;
+        gaps[g++]=1;
+        for(auto h : fixed)
+            if(h>gaps[g-1] && h<n && g<max_gaps) gaps[g++]=h;
+        return g;
+    }
+};
+
+template<class Gaps=CiuraGaps, class RandomIt, class Compare, class Trace>
+void shell_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    std::ptrdiff_t n=last-first, gaps[max_gaps];
+    int g=Gaps::fill(n,gaps);
+    while(--g>0) detail::hsort(first,0,n,gaps[g],comp,tr);
+    //последний проход с шагом 1 -- обычные вставки с постоянным шагом
+    detail::insertion(first,0,n,comp,tr);
+}
+
+template<class Gaps=CiuraGaps, class RandomIt, class Compare>
+void shell_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    shell_sort<Gaps>(first,last,comp,tr);
+}
+
+template<class Gaps=CiuraGaps, class RandomIt>
+void shell_sort(RandomIt first, RandomIt last)
+{
+    shell_sort<Gaps>(first,last,std::less<>());
+}
+
+}
+
+#endif //SORT_SHELL_H
@@ -0,0 +1,513 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Simd.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include "Network.h"
+#include "Parallel.h"
+#include "Pdq.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SORT_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace sortcore {
+
+const char *name(SimdLevel l)
+{
+    switch(l)
+    {
+        case SimdLevel::Scalar: return "без векторных инструкций";
+        case SimdLevel::Sse42: return "SSE4.2";
+        case SimdLevel::Avx2: return "AVX2";
+    }
+    return "";
+}
+
+const char *id(SimdLevel l)
+{
+    switch(l)
+    {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::Sse42: return "sse42";
+        case SimdLevel::Avx2: return "avx2";
+    }
+    return "";
+}
+
+namespace {
+
+SimdLevel detect()
+{
+    SimdLevel l=SimdLevel::Scalar;
+#ifdef SORT_X86
+    unsigned a, b, c, d;
+    if(!__get_cpuid(1,&a,&b,&c,&d)) return l;
+    if((c&bit_SSE4_2) && (c&bit_POPCNT)) l=SimdLevel::Sse42;
+    //регистры ymm должны сохраняться ОС при переключении задач
+    if((c&bit_OSXSAVE) && (c&bit_AVX) && __get_cpuid_max(0,nullptr)>=7)
+    {
+        unsigned lo, hi;
+        __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        __cpuid_count(7,0,a,b,c,d);
+        if((lo&6)==6 && (b&bit_AVX2) && l==SimdLevel::Sse42) l=SimdLevel::Avx2;
+    }
+#endif
+    const char *env=std::getenv("SORT_SIMD");
+    if(env && std::strcmp(env,"scalar")==0) l=SimdLevel::Scalar;
+    if(env && std::strcmp(env,"sse42")==0 && l>SimdLevel::Sse42) l=SimdLevel::Sse42;
+    return l;
+}
+
+#ifdef SORT_X86
+
+//Таблица упаковки для 8 двойных слов: по маске левых полос -- индексы
+//двойных слов, сначала левые полосы по порядку, затем правые; по 4 бита
+//на индекс. lanes полос занимают по 8/lanes двойных слов.
+struct PackedTable{
+    std::uint32_t v[256];
+};
+
+constexpr PackedTable make_packed(unsigned lanes)
+{
+    PackedTable t{{0}};
+    const unsigned w=8/lanes;
+    for(unsigned m=0;m<(1u<<lanes);m++)
+    {
+        unsigned k=0;
+        for(unsigned pass=0;pass<2;pass++)
+            for(unsigned l=0;l<lanes;l++)
+                if(((m>>l)&1)==(pass==0 ? 1u : 0u))
+                    for(unsigned d=0;d<w;d++,k++) t.v[m]|=(l*w+d)<<(4*k);
+    }
+    return t;
+}
+
+//То же для 16 байт регистра SSE: готовые маски pshufb
+struct ByteTable{
+    unsigned char b[16][16];
+};
+
+constexpr ByteTable make_bytes(unsigned lanes)
+{
+    ByteTable t{{{0}}};
+    const unsigned w=16/lanes;
+    for(unsigned m=0;m<(1u<<lanes);m++)
+    {
+        unsigned k=0;
+        for(unsigned pass=0;pass<2;pass++)
+            for(unsigned l=0;l<lanes;l++)
+                if(((m>>l)&1)==(pass==0 ? 1u : 0u))
+                    for(unsigned d=0;d<w;d++,k++) t.b[m][k]=(unsigned char)(l*w+d);
+    }
+    return t;
+}
+
+const PackedTable packed8=make_packed(8), packed4=make_packed(4);
+const ByteTable bytes4=make_bytes(4), bytes2=make_bytes(2);
+
+//Маска шага битонной сети для двойного слова d (полоса d/w): полоса берёт
+//максимум пары, если она в правой половине пары и в блоке по возрастанию,
+//или в левой половине и в блоке по убыванию
+constexpr int lane_mask(unsigned d, unsigned w, unsigned K, unsigned J)
+{
+    return (((d/w)&K)!=0)!=(((d/w)&J)!=0) ? -1 : 0;
+}
+
+#define SORT_MASK8(w) _mm256_setr_epi32(lane_mask(0,w,K,J),lane_mask(1,w,K,J),lane_mask(2,w,K,J),lane_mask(3,w,K,J),\
+                                        lane_mask(4,w,K,J),lane_mask(5,w,K,J),lane_mask(6,w,K,J),lane_mask(7,w,K,J))
+#define SORT_MASK4(w) _mm_setr_epi32(lane_mask(0,w,K,J),lane_mask(1,w,K,J),lane_mask(2,w,K,J),lane_mask(3,w,K,J))
+
+#define SORT_TARGET __attribute__((target("sse4.2,popcnt")))
+namespace sse42 {
+
+struct I32{
+    typedef std::int32_t T;
+    typedef __m128i V;
+    static const unsigned L=4;
+    static T top() { return std::numeric_limits<T>::max(); }
+    SORT_TARGET static V load(const T *p) { return _mm_loadu_si128((const __m128i*)p); }
+    SORT_TARGET static void store(T *p, V v) { _mm_storeu_si128((__m128i*)p,v); }
+    SORT_TARGET static V set1(T x) { return _mm_set1_epi32(x); }
+    SORT_TARGET static V min(V a, V b) { return _mm_min_epi32(a,b); }
+    SORT_TARGET static V max(V a, V b) { return _mm_max_epi32(a,b); }
+    SORT_TARGET static V blend(V a, V b, __m128i m) { return _mm_blendv_epi8(a,b,m); }
+    SORT_TARGET static unsigned less(V v, V p) { return (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(p,v))); }
+    SORT_TARGET static unsigned not_greater(V v, V p) {
+        return ~(unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(v,p)))&0xf;
+    }
+    SORT_TARGET static V compress(V v, unsigned m) {
+        return _mm_shuffle_epi8(v,_mm_loadu_si128((const __m128i*)bytes4.b[m]));
+    }
+    template<unsigned J> SORT_TARGET static V swap_lanes(V v) {
+        return J==1 ? _mm_shuffle_epi32(v,_MM_SHUFFLE(2,3,0,1)) : _mm_shuffle_epi32(v,_MM_SHUFFLE(1,0,3,2));
+    }
+    template<unsigned K, unsigned J> SORT_TARGET static __m128i mask() { return SORT_MASK4(1); }
+    SORT_TARGET static void transpose(V *r) {
+        __m128 f[4];
+        for(unsigned l=0;l<4;l++) f[l]=_mm_castsi128_ps(r[l]);
+        _MM_TRANSPOSE4_PS(f[0],f[1],f[2],f[3]);
+        for(unsigned l=0;l<4;l++) r[l]=_mm_castps_si128(f[l]);
+    }
+};
+
+struct I64{
+    typedef std::int64_t T;
+    typedef __m128i V;
+    static const unsigned L=2;
+    static T top() { return std::numeric_limits<T>::max(); }
+    SORT_TARGET static V load(const T *p) { return _mm_loadu_si128((const __m128i*)p); }
+    SORT_TARGET static void store(T *p, V v) { _mm_storeu_si128((__m128i*)p,v); }
+    SORT_TARGET static V set1(T x) { return _mm_set1_epi64x(x); }
+    SORT_TARGET static V min(V a, V b) { return _mm_blendv_epi8(a,b,_mm_cmpgt_epi64(a,b)); }
+    SORT_TARGET static V max(V a, V b) { return _mm_blendv_epi8(b,a,_mm_cmpgt_epi64(a,b)); }
+    SORT_TARGET static V blend(V a, V b, __m128i m) { return _mm_blendv_epi8(a,b,m); }
+    SORT_TARGET static unsigned less(V v, V p) { return (unsigned)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(p,v))); }
+    SORT_TARGET static unsigned not_greater(V v, V p) {
+        return ~(unsigned)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v,p)))&0x3;
+    }
+    SORT_TARGET static V compress(V v, unsigned m) {
+        return _mm_shuffle_epi8(v,_mm_loadu_si128((const __m128i*)bytes2.b[m]));
+    }
+    template<unsigned J> SORT_TARGET static V swap_lanes(V v) { return _mm_shuffle_epi32(v,_MM_SHUFFLE(1,0,3,2)); }
+    template<unsigned K, unsigned J> SORT_TARGET static __m128i mask() { return SORT_MASK4(2); }
+};
+
+struct F32{
+    typedef float T;
+    typedef __m128 V;
+    static const unsigned L=4;
+    static T top() { return std::numeric_limits<T>::infinity(); }
+    SORT_TARGET static V load(const T *p) { return _mm_loadu_ps(p); }
+    SORT_TARGET static void store(T *p, V v) { _mm_storeu_ps(p,v); }
+    SORT_TARGET static V set1(T x) { return _mm_set1_ps(x); }
+    SORT_TARGET static V min(V a, V b) { return _mm_min_ps(a,b); }
+    SORT_TARGET static V max(V a, V b) { return _mm_max_ps(a,b); }
+    SORT_TARGET static V blend(V a, V b, __m128i m) { return _mm_blendv_ps(a,b,_mm_castsi128_ps(m)); }
+    SORT_TARGET static unsigned less(V v, V p) { return (unsigned)_mm_movemask_ps(_mm_cmplt_ps(v,p)); }
+    SORT_TARGET static unsigned not_greater(V v, V p) { return (unsigned)_mm_movemask_ps(_mm_cmple_ps(v,p)); }
+    SORT_TARGET static V compress(V v, unsigned m) {
+        return _mm_castsi128_ps(_mm_shuffle_epi8(_mm_castps_si128(v),_mm_loadu_si128((const __m128i*)bytes4.b[m])));
+    }
+    template<unsigned J> SORT_TARGET static V swap_lanes(V v) {
+        return J==1 ? _mm_shuffle_ps(v,v,_MM_SHUFFLE(2,3,0,1)) : _mm_shuffle_ps(v,v,_MM_SHUFFLE(1,0,3,2));
+    }
+    template<unsigned K, unsigned J> SORT_TARGET static __m128i mask() { return SORT_MASK4(1); }
+    SORT_TARGET static void transpose(V *r) { _MM_TRANSPOSE4_PS(r[0],r[1],r[2],r[3]); }
+};
+
+#include "SimdKernels.h"
+
+}
+#undef SORT_TARGET
+
+#define SORT_TARGET __attribute__((target("avx2,popcnt")))
+namespace avx2 {
+
+//Индексы упаковки из 4-битной записи: сдвиг каждого двойного слова на свою
+//тетраду, старшие биты permutevar8x32 не смотрит
+SORT_TARGET inline __m256i unpack(std::uint32_t packed)
+{
+    return _mm256_srlv_epi32(_mm256_set1_epi32((int)packed),_mm256_setr_epi32(0,4,8,12,16,20,24,28));
+}
+
+//Транспонирование 8x8 двойных слов: чередование пар, четвёрок и половин
+SORT_TARGET inline void transpose8(__m256 *r)
+{
+    __m256 t[8], s[8];
+    for(unsigned k=0;k<4;k++)
+    {
+        t[2*k]=_mm256_unpacklo_ps(r[2*k],r[2*k+1]);
+        t[2*k+1]=_mm256_unpackhi_ps(r[2*k],r[2*k+1]);
+    }
+    for(unsigned k=0;k<2;k++)
+    {
+        s[4*k]=_mm256_shuffle_ps(t[4*k],t[4*k+2],_MM_SHUFFLE(1,0,1,0));
+        s[4*k+1]=_mm256_shuffle_ps(t[4*k],t[4*k+2],_MM_SHUFFLE(3,2,3,2));
+        s[4*k+2]=_mm256_shuffle_ps(t[4*k+1],t[4*k+3],_MM_SHUFFLE(1,0,1,0));
+        s[4*k+3]=_mm256_shuffle_ps(t[4*k+1],t[4*k+3],_MM_SHUFFLE(3,2,3,2));
+    }
+    for(unsigned k=0;k<4;k++)
+    {
+        r[k]=_mm256_permute2f128_ps(s[k],s[k+4],0x20);
+        r[k+4]=_mm256_permute2f128_ps(s[k],s[k+4],0x31);
+    }
+}
+
+struct I32{
+    typedef std::int32_t T;
+    typedef __m256i V;
+    static const unsigned L=8;
+    static T top() { return std::numeric_limits<T>::max(); }
+    SORT_TARGET static V load(const T *p) { return _mm256_loadu_si256((const __m256i*)p); }
+    SORT_TARGET static void store(T *p, V v) { _mm256_storeu_si256((__m256i*)p,v); }
+    SORT_TARGET static V set1(T x) { return _mm256_set1_epi32(x); }
+    SORT_TARGET static V min(V a, V b) { return _mm256_min_epi32(a,b); }
+    SORT_TARGET static V max(V a, V b) { return _mm256_max_epi32(a,b); }
+    SORT_TARGET static V blend(V a, V b, __m256i m) { return _mm256_blendv_epi8(a,b,m); }
+    SORT_TARGET static unsigned less(V v, V p) {
+        return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(p,v)));
+    }
+    SORT_TARGET static unsigned not_greater(V v, V p) {
+        return ~(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(v,p)))&0xff;
+    }
+    SORT_TARGET static V compress(V v, unsigned m) { return _mm256_permutevar8x32_epi32(v,unpack(packed8.v[m])); }
+    template<unsigned J> SORT_TARGET static V swap_lanes(V v) {
+        return J==1 ? _mm256_shuffle_epi32(v,_MM_SHUFFLE(2,3,0,1)) :
+               J==2 ? _mm256_shuffle_epi32(v,_MM_SHUFFLE(1,0,3,2)) : _mm256_permute2x128_si256(v,v,1);
+    }
+    template<unsigned K, unsigned J> SORT_TARGET static __m256i mask() { return SORT_MASK8(1); }
+    SORT_TARGET static void transpose(V *r) {
+        __m256 f[8];
+        for(unsigned l=0;l<8;l++) f[l]=_mm256_castsi256_ps(r[l]);
+        transpose8(f);
+        for(unsigned l=0;l<8;l++) r[l]=_mm256_castps_si256(f[l]);
+    }
+};
+
+struct I64{
+    typedef std::int64_t T;
+    typedef __m256i V;
+    static const unsigned L=4;
+    static T top() { return std::numeric_limits<T>::max(); }
+    SORT_TARGET static V load(const T *p) { return _mm256_loadu_si256((const __m256i*)p); }
+    SORT_TARGET static void store(T *p, V v) { _mm256_storeu_si256((__m256i*)p,v); }
+    SORT_TARGET static V set1(T x) { return _mm256_set1_epi64x(x); }
+    SORT_TARGET static V min(V a, V b) { return _mm256_blendv_epi8(a,b,_mm256_cmpgt_epi64(a,b)); }
+    SORT_TARGET static V max(V a, V b) { return _mm256_blendv_epi8(b,a,_mm256_cmpgt_epi64(a,b)); }
+    SORT_TARGET static V blend(V a, V b, __m256i m) { return _mm256_blendv_epi8(a,b,m); }
+    SORT_TARGET static unsigned less(V v, V p) {
+        return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(p,v)));
+    }
+    SORT_TARGET static unsigned not_greater(V v, V p) {
+        return ~(unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v,p)))&0xf;
+    }
+    SORT_TARGET static V compress(V v, unsigned m) { return _mm256_permutevar8x32_epi32(v,unpack(packed4.v[m])); }
+    template<unsigned J> SORT_TARGET static V swap_lanes(V v) {
+        return J==1 ? _mm256_shuffle_epi32(v,_MM_SHUFFLE(1,0,3,2)) : _mm256_permute2x128_si256(v,v,1);
+    }
+    template<unsigned K, unsigned J> SORT_TARGET static __m256i mask() { return SORT_MASK8(2); }
+};
+
+struct F32{
+    typedef float T;
+    typedef __m256 V;
+    static const unsigned L=8;
+    static T top() { return std::numeric_limits<T>::infinity(); }
+    SORT_TARGET static V load(const T *p) { return _mm256_loadu_ps(p); }
+    SORT_TARGET static void store(T *p, V v) { _mm256_storeu_ps(p,v); }
+    SORT_TARGET static V set1(T x) { return _mm256_set1_ps(x); }
+    SORT_TARGET static V min(V a, V b) { return _mm256_min_ps(a,b); }
+    SORT_TARGET static V max(V a, V b) { return _mm256_max_ps(a,b); }
+    SORT_TARGET static V blend(V a, V b, __m256i m) { return _mm256_blendv_ps(a,b,_mm256_castsi256_ps(m)); }
+    SORT_TARGET static unsigned less(V v, V p) { return (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(v,p,_CMP_LT_OQ)); }
+    SORT_TARGET static unsigned not_greater(V v, V p) {
+        return (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(v,p,_CMP_LE_OQ));
+    }
+    SORT_TARGET static V compress(V v, unsigned m) { return _mm256_permutevar8x32_ps(v,unpack(packed8.v[m])); }
+    template<unsigned J> SORT_TARGET static V swap_lanes(V v) {
+        return J==1 ? _mm256_permute_ps(v,_MM_SHUFFLE(2,3,0,1)) :
+               J==2 ? _mm256_permute_ps(v,_MM_SHUFFLE(1,0,3,2)) : _mm256_permute2f128_ps(v,v,1);
+    }
+    template<unsigned K, unsigned J> SORT_TARGET static __m256i mask() { return SORT_MASK8(1); }
+    SORT_TARGET static void transpose(V *r) { transpose8(r); }
+};
+
+#include "SimdKernels.h"
+
+}
+#undef SORT_TARGET
+#undef SORT_MASK8
+#undef SORT_MASK4
+
+#endif
+
+template<class T, class Sse, class Avx>
+void dispatch(T *first, T *last)
+{
+    std::size_t n=last-first;
+    if(n<2) return;
+#ifdef SORT_X86
+    int bad=detail::log2_floor((std::ptrdiff_t)n);
+    switch(simd_level())
+    {
+        case SimdLevel::Avx2: avx2::quick<Avx>(first,n,bad); return;
+        case SimdLevel::Sse42: sse42::quick<Sse>(first,n,bad); return;
+        case SimdLevel::Scalar: break;
+    }
+#endif
+    pdq_sort(first,last);
+}
+
+//Полос в самом широком регистре
+const unsigned batch_lanes=8;
+//Столько массивов подряд поток берёт из общей очереди за раз
+const std::size_t batch_chunk=4096;
+
+//Сеть слияния обменами для пакетной сортировки: длиннее network_max, поэтому
+//строится во время работы тем же правилом, что и Network
+struct Comparators{
+    std::vector<unsigned char> i, j;
+    void add(std::size_t a, std::size_t b) {
+        i.push_back((unsigned char)a);
+        j.push_back((unsigned char)b);
+    }
+};
+
+const Comparators &batch_network(std::size_t n)
+{
+    static const std::vector<Comparators> nets=[] {
+        std::vector<Comparators> v(batch_max+1);
+        for(std::size_t n=0;n<=batch_max;n++) detail::merge_exchange(n,v[n]);
+        return v;
+    }();
+    return nets[n];
+}
+
+//Ядро группы для текущего набора инструкций; lanes==0 -- векторного нет
+template<class T>
+struct BatchKernel{
+    unsigned lanes;
+    void (*group)(T *const*, const std::size_t*, std::size_t, const unsigned char*, const unsigned char*, std::size_t);
+};
+
+template<class T>
+struct FixedRows{
+    T *data;
+    std::size_t len;
+    T *row(std::size_t i) const { return data+i*len; }
+    std::size_t size(std::size_t) const { return len; }
+};
+
+template<class T>
+struct OffsetRows{
+    T *data;
+    const std::size_t *offsets;
+    T *row(std::size_t i) const { return data+offsets[i]; }
+    std::size_t size(std::size_t i) const { return offsets[i+1]-offsets[i]; }
+};
+
+//Массивы [b, e): короткие набираются в группы по lanes, сеть -- по самому
+//длинному в группе; длинные и все без векторного ядра -- по одному
+template<class T, class Rows>
+void batch_range(const Rows &rows, std::size_t b, std::size_t e, const BatchKernel<T> &k)
+{
+    T *row[batch_lanes];
+    std::size_t len[batch_lanes], n=0;
+    unsigned g=0;
+    for(std::size_t i=b;i<e;i++)
+    {
+        T *r=rows.row(i);
+        std::size_t m=rows.size(i);
+        if(m<2) continue;
+        if(k.lanes==0 || m>batch_max)
+        {
+            simd_sort(r,r+m);
+            continue;
+        }
+        row[g]=r;
+        len[g]=m;
+        if(m>n) n=m;
+        if(++g<k.lanes && i+1<e) continue;
+        for(;g<k.lanes;g++) { row[g]=nullptr; len[g]=0; }
+        const Comparators &net=batch_network(n);
+        k.group(row,len,n,net.i.data(),net.j.data(),net.i.size());
+        g=0;
+        n=0;
+    }
+    if(g)
+    {
+        for(;g<k.lanes;g++) { row[g]=nullptr; len[g]=0; }
+        const Comparators &net=batch_network(n);
+        k.group(row,len,n,net.i.data(),net.j.data(),net.i.size());
+    }
+}
+
+//Пакетную сортировку зовут часто и на небольших объёмах: потоки держатся
+//между вызовами
+detail::WorkerPool &batch_pool()
+{
+    static detail::WorkerPool pool;
+    return pool;
+}
+
+template<class T, class Rows>
+void batch_run(const Rows &rows, std::size_t count, const BatchKernel<T> &k, unsigned threads)
+{
+    std::size_t chunks=(count+batch_chunk-1)/batch_chunk;
+    if(chunks==0) return;
+    unsigned p=(unsigned)std::min<std::size_t>(threads_or_default(threads),chunks);
+    std::atomic<std::size_t> next(0);
+    batch_pool().run(p,[&](unsigned) {
+        for(std::size_t c=next++;c<chunks;c=next++)
+            batch_range(rows,c*batch_chunk,std::min(count,(c+1)*batch_chunk),k);
+    });
+}
+
+#ifdef SORT_X86
+template<class T, class Sse, class Avx>
+BatchKernel<T> batch_kernel()
+{
+    switch(simd_level())
+    {
+        case SimdLevel::Avx2: return BatchKernel<T>{Avx::L,&avx2::batch<Avx>};
+        case SimdLevel::Sse42: return BatchKernel<T>{Sse::L,&sse42::batch<Sse>};
+        case SimdLevel::Scalar: break;
+    }
+    return BatchKernel<T>{0,nullptr};
+}
+
+BatchKernel<std::int32_t> kernel_for(std::int32_t*) { return batch_kernel<std::int32_t,sse42::I32,avx2::I32>(); }
+BatchKernel<float> kernel_for(float*) { return batch_kernel<float,sse42::F32,avx2::F32>(); }
+#else
+template<class T>
+BatchKernel<T> kernel_for(T*) { return BatchKernel<T>{0,nullptr}; }
+#endif
+
+}
+
+SimdLevel simd_level()
+{
+    static const SimdLevel l=detect();
+    return l;
+}
+
+#ifdef SORT_X86
+void simd_sort(std::int32_t *first, std::int32_t *last) { dispatch<std::int32_t,sse42::I32,avx2::I32>(first,last); }
+void simd_sort(std::int64_t *first, std::int64_t *last) { dispatch<std::int64_t,sse42::I64,avx2::I64>(first,last); }
+void simd_sort(float *first, float *last) { dispatch<float,sse42::F32,avx2::F32>(first,last); }
+#else
+void simd_sort(std::int32_t *first, std::int32_t *last) { pdq_sort(first,last); }
+void simd_sort(std::int64_t *first, std::int64_t *last) { pdq_sort(first,last); }
+void simd_sort(float *first, float *last) { pdq_sort(first,last); }
+#endif
+
+void batch_sort(std::int32_t *data, std::size_t count, std::size_t len, unsigned threads)
+{
+    batch_run(FixedRows<std::int32_t>{data,len},count,kernel_for(data),threads);
+}
+
+void batch_sort(float *data, std::size_t count, std::size_t len, unsigned threads)
+{
+    batch_run(FixedRows<float>{data,len},count,kernel_for(data),threads);
+}
+
+void batch_sort_offsets(std::int32_t *data, const std::size_t *offsets, std::size_t count, unsigned threads)
+{
+    batch_run(OffsetRows<std::int32_t>{data,offsets},count,kernel_for(data),threads);
+}
+
+void batch_sort_offsets(float *data, const std::size_t *offsets, std::size_t count, unsigned threads)
+{
+    batch_run(OffsetRows<float>{data,offsets},count,kernel_for(data),threads);
+}
+
+}
@@ -0,0 +1,69 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_SIMD_H
+#define SORT_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Trace.h"
+
+namespace sortcore {
+
+//Наборы векторных инструкций по возрастанию; Scalar -- без векторного пути
+enum class SimdLevel{Scalar, Sse42, Avx2};
+
+//Лучший уровень, который есть у процессора (CPUID) и включён ОС (XGETBV);
+//определяется один раз. Переменная окружения SORT_SIMD=scalar|sse42
+//ограничивает его сверху -- для сравнения ядер на одной машине.
+SimdLevel simd_level();
+const char *name(SimdLevel l);
+const char *id(SimdLevel l);
+
+//Векторная быстрая сортировка: разбиение регистрами с упаковкой левых
+//элементов по таблице перестановок и битонная сеть в регистрах на коротких
+//отрезках. Ядро выбирается по simd_level(), без векторных инструкций --
+//pdqsort. Для float NaN, как и в остальных сортировках, недопустим.
+void simd_sort(std::int32_t *first, std::int32_t *last);
+void simd_sort(std::int64_t *first, std::int64_t *last);
+void simd_sort(float *first, float *last);
+
+//Пакетная сортировка множества коротких массивов одним вызовом. Группа из
+//стольких массивов, сколько полос в регистре, транспонируется: i-й регистр
+//держит i-е элементы всех массивов группы, и одна сеть компараторов из
+//вертикальных min/max сортирует каждую полосу -- свой массив -- без
+//ветвлений. Массивы длиннее batch_max сортируются по одному simd_sort.
+//Массивы делятся порциями между threads потоками (0 -- по числу аппаратных);
+//потоки постоянные и переиспользуются следующими вызовами.
+const std::size_t batch_max=64;
+
+//count массивов по len элементов подряд
+void batch_sort(std::int32_t *data, std::size_t count, std::size_t len, unsigned threads=0);
+void batch_sort(float *data, std::size_t count, std::size_t len, unsigned threads=0);
+
+//Массивы разной длины: i-й -- data[offsets[i]..offsets[i+1]), в offsets
+//count+1 элементов
+void batch_sort_offsets(std::int32_t *data, const std::size_t *offsets, std::size_t count, unsigned threads=0);
+void batch_sort_offsets(float *data, const std::size_t *offsets, std::size_t count, unsigned threads=0);
+
+//С трассировкой ядро по шагам не видно: результат ложится записями поверх
+//исходного массива только там, где значение изменилось
+template<class Trace>
+void simd_sort(int *first, int *last, Trace &tr)
+{
+    if(!Trace::enabled)
+    {
+        simd_sort(first,last);
+        return;
+    }
+    std::vector<int> old(first,last);
+    simd_sort(first,last);
+    for(std::ptrdiff_t i=0;i<last-first;i++)
+        if(first[i]!=old[i]) tr.write(i,first[i]);
+}
+
+}
+
+#endif //SORT_SIMD_H
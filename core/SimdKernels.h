@@ -0,0 +1,234 @@
+//
+// Created by andrew on 18.10.26.
+//
+//Без защиты от повторного включения: Simd.cpp включает этот файл в
+//пространство имён каждого набора инструкций, определив перед этим
+//SORT_TARGET (атрибут target для всех функций) и обёртки I32, I64, F32
+//над регистрами. Обёртка S даёт тип элемента T, регистр V, число полос L,
+//load/store/set1/min/max/blend, маски less/not_greater, сжатие compress,
+//перестановку полос swap_lanes<J>, маску mask<K,J> шага битонной сети и
+//транспонирование transpose блока из L регистров (нужно только пакетной).
+//
+
+//Шаг битонной сети: сравнение элементов x и x^J внутри блоков длины K.
+//J>=L -- элементы в разных регистрах, хватает вертикальных min/max.
+template<class S, unsigned R, unsigned K, unsigned J, bool Cross=(J>=S::L)>
+struct Stage{
+    SORT_TARGET static void run(typename S::V *reg) {
+        const unsigned step=J/S::L;
+        for(unsigned r=0;r<R;r++)
+            if(!(r&step))
+            {
+                typename S::V mn=S::min(reg[r],reg[r|step]), mx=S::max(reg[r],reg[r|step]);
+                bool up=((r*S::L)&K)==0;
+                reg[r]=up ? mn : mx;
+                reg[r|step]=up ? mx : mn;
+            }
+    }
+};
+
+//J<L -- пары внутри регистра: перестановка полос, min/max и смешивание по
+//маске; блок длины K>=L целиком в регистре и сортируется в одну сторону
+template<class S, unsigned R, unsigned K, unsigned J>
+struct Stage<S,R,K,J,false>{
+    SORT_TARGET static void run(typename S::V *reg) {
+        const auto m=S::template mask<(K<S::L ? K : 0),J>();
+        for(unsigned r=0;r<R;r++)
+        {
+            typename S::V t=S::template swap_lanes<J>(reg[r]);
+            typename S::V mn=S::min(reg[r],t), mx=S::max(reg[r],t);
+            reg[r]=K>=S::L && ((r*S::L)&K) ? S::blend(mx,mn,m) : S::blend(mn,mx,m);
+        }
+    }
+};
+
+template<class S, unsigned R, unsigned K, unsigned J>
+struct Merge{
+    SORT_TARGET static void run(typename S::V *reg) {
+        Stage<S,R,K,J>::run(reg);
+        Merge<S,R,K,J/2>::run(reg);
+    }
+};
+
+template<class S, unsigned R, unsigned K>
+struct Merge<S,R,K,0>{
+    SORT_TARGET static void run(typename S::V*) {}
+};
+
+//Битонная сортировка R регистров целиком в регистрах: log(RL)(log(RL)+1)/2 шагов
+template<class S, unsigned R, unsigned K=2, bool Done=(K>R*S::L)>
+struct Bitonic{
+    SORT_TARGET static void run(typename S::V *reg) {
+        Merge<S,R,K,K/2>::run(reg);
+        Bitonic<S,R,2*K>::run(reg);
+    }
+};
+
+template<class S, unsigned R, unsigned K>
+struct Bitonic<S,R,K,true>{
+    SORT_TARGET static void run(typename S::V*) {}
+};
+
+template<class S, unsigned R>
+SORT_TARGET void bitonic(typename S::T *buf)
+{
+    typename S::V reg[R];
+    for(unsigned r=0;r<R;r++) reg[r]=S::load(buf+r*S::L);
+    Bitonic<S,R>::run(reg);
+    for(unsigned r=0;r<R;r++) S::store(buf+r*S::L,reg[r]);
+}
+
+//До small_regs регистров: хвост дополняется наибольшим значением
+const unsigned small_regs=8;
+
+template<class S>
+SORT_TARGET void small(typename S::T *a, std::size_t n)
+{
+    typename S::T buf[small_regs*S::L];
+    for(std::size_t i=0;i<n;i++) buf[i]=a[i];
+    for(std::size_t i=n;i<small_regs*S::L;i++) buf[i]=S::top();
+    if(n<=S::L) bitonic<S,1>(buf);
+    else if(n<=2*S::L) bitonic<S,2>(buf);
+    else if(n<=4*S::L) bitonic<S,4>(buf);
+    else bitonic<S,8>(buf);
+    for(std::size_t i=0;i<n;i++) a[i]=buf[i];
+}
+
+//Разбирает регистр v: левые элементы сжимаются в начало регистра, и он целиком
+//пишется и слева (с lw), и справа (до rw) -- лишнее ложится в уже прочитанное
+template<class S, bool Le>
+SORT_TARGET inline void put(typename S::T *a, typename S::V v, typename S::V p, std::size_t &lw, std::size_t &rw)
+{
+    unsigned m=Le ? S::not_greater(v,p) : S::less(v,p);
+    typename S::V c=S::compress(v,m);
+    unsigned k=(unsigned)__builtin_popcount(m);
+    S::store(a+lw,c);
+    S::store(a+rw-S::L,c);
+    lw+=k;
+    rw-=S::L-k;
+}
+
+//Разбиение a[0..n), n>=2L, на месте: слева x<pivot (при Le -- x<=pivot).
+//Первый и последний регистры откладываются, чтобы с обеих сторон было место;
+//читается та сторона, где свободного места меньше, поэтому обе записи
+//регистра целиком всегда попадают в уже прочитанное.
+template<class S, bool Le>
+SORT_TARGET std::size_t partition(typename S::T *a, std::size_t n, typename S::T pivot)
+{
+    typedef typename S::T T;
+    typedef typename S::V V;
+    V p=S::set1(pivot), first=S::load(a), last=S::load(a+n-S::L);
+    std::size_t lr=S::L, rr=n-S::L, lw=0, rw=n;
+    while(rr-lr>=S::L)
+    {
+        V v;
+        if(lr-lw<=rw-rr)
+        {
+            v=S::load(a+lr);
+            lr+=S::L;
+        }
+        else
+        {
+            rr-=S::L;
+            v=S::load(a+rr);
+        }
+        put<S,Le>(a,v,p,lw,rw);
+    }
+    //хвост короче регистра: сначала в сторону, затем поштучно
+    T tail[S::L];
+    std::size_t rest=rr-lr;
+    for(std::size_t i=0;i<rest;i++) tail[i]=a[lr+i];
+    for(std::size_t i=0;i<rest;i++)
+    {
+        if(Le ? !(pivot<tail[i]) : tail[i]<pivot) a[lw++]=tail[i];
+        else a[--rw]=tail[i];
+    }
+    put<S,Le>(a,first,p,lw,rw);
+    put<S,Le>(a,last,p,lw,rw);
+    return lw;
+}
+
+//Быстрая сортировка: опорный -- медиана девяти, короткие отрезки -- битонной
+//сетью в регистрах, после bad перекошенных разбиений -- pdqsort
+template<class S>
+SORT_TARGET void quick(typename S::T *a, std::size_t n, int bad)
+{
+    typedef typename S::T T;
+    while(n>small_regs*S::L)
+    {
+        T s[9];
+        for(std::size_t i=0;i<9;i++) s[i]=a[(2*i+1)*n/18];
+        network_sort<9>(s);
+        T pivot=s[4];
+        std::size_t p=partition<S,false>(a,n,pivot);
+        if(p==0)
+        {
+            //меньших нет: равные опорному отделяются и больше не трогаются
+            p=partition<S,true>(a,n,pivot);
+            a+=p;
+            n-=p;
+            continue;
+        }
+        if((p<n/8 || n-p<n/8) && --bad==0)
+        {
+            pdq_sort(a,a+n);
+            return;
+        }
+        if(p<n-p)
+        {
+            quick<S>(a,p,bad);
+            a+=p;
+            n-=p;
+        }
+        else
+        {
+            quick<S>(a+p,n-p,bad);
+            n=p;
+        }
+    }
+    if(n>1) small<S>(a,n);
+}
+
+//Пакетная сортировка группы из L массивов rows[l] длиной len[l]<=n<=batch_max
+//(пустые полосы -- len[l]==0). Массивы транспонируются в col: строка i -- это
+//i-е элементы всех L массивов, хвосты дополнены наибольшим значением. Тогда
+//сеть на n элементов из вертикальных min/max сортирует каждую полосу отдельно.
+//Блоки LxL, целиком лежащие во всех массивах группы, переставляются в
+//регистрах, остаток -- поштучно.
+template<class S>
+SORT_TARGET void batch(typename S::T *const *rows, const std::size_t *len, std::size_t n,
+                       const unsigned char *ci, const unsigned char *cj, std::size_t nc)
+{
+    typedef typename S::T T;
+    typedef typename S::V V;
+    T col[batch_max*S::L];
+    std::size_t common=n;
+    for(unsigned l=0;l<S::L;l++)
+        if(len[l]<common) common=len[l];
+    std::size_t blocks=common/S::L*S::L;
+    for(std::size_t c=0;c<blocks;c+=S::L)
+    {
+        V r[S::L];
+        for(unsigned l=0;l<S::L;l++) r[l]=S::load(rows[l]+c);
+        S::transpose(r);
+        for(unsigned l=0;l<S::L;l++) S::store(col+(c+l)*S::L,r[l]);
+    }
+    for(unsigned l=0;l<S::L;l++)
+        for(std::size_t i=blocks;i<n;i++) col[i*S::L+l]=i<len[l] ? rows[l][i] : S::top();
+    for(std::size_t k=0;k<nc;k++)
+    {
+        T *x=col+ci[k]*S::L, *y=col+cj[k]*S::L;
+        V a=S::load(x), b=S::load(y);
+        S::store(x,S::min(a,b));
+        S::store(y,S::max(a,b));
+    }
+    for(std::size_t c=0;c<blocks;c+=S::L)
+    {
+        V r[S::L];
+        for(unsigned l=0;l<S::L;l++) r[l]=S::load(col+(c+l)*S::L);
+        S::transpose(r);
+        for(unsigned l=0;l<S::L;l++) S::store(rows[l]+c,r[l]);
+    }
+    for(unsigned l=0;l<S::L;l++)
+        for(std::size_t i=blocks;i<len[l];i++) rows[l][i]=col[i*S::L+l];
+}
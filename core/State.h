@@ -0,0 +1,18 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_STATE_H
+#define SORT_STATE_H
+
+#include <vector>
+#include <utility>
+
+//Один шаг визуализации: массив после операции, подпись и пара затронутых индексов
+struct State{
+    std::vector<int> cur;
+    char statestr[512];
+    std::pair<int,int> sw;
+};
+
+#endif //SORT_STATE_H
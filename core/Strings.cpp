@@ -0,0 +1,194 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Strings.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include "Ingest.h"
+
+namespace sortcore {
+
+namespace {
+
+//Короче этого -- вставками по полным строкам
+const std::size_t mkqs_threshold=16;
+//Корзины MSD короче этого уходят в multikey_sort
+const std::size_t string_radix_threshold=1<<10;
+
+//Строка кончилась в пределах ключа: младший байт -- ноль-терминатор или за ним
+inline bool ended(std::uint64_t key) { return (key&0xff)==0; }
+
+void reload(StringKey *a, std::size_t n, std::size_t depth)
+{
+    for(std::size_t i=0;i<n;i++) a[i].prefix=load_key(a[i].s+depth);
+}
+
+//Строки с равными первыми depth байтами
+bool less_from(const StringKey &x, const StringKey &y, std::size_t depth)
+{
+    if(x.prefix!=y.prefix) return x.prefix<y.prefix;
+    if(ended(x.prefix)) return false;
+    return std::strcmp(x.s+depth+8,y.s+depth+8)<0;
+}
+
+void insertion(StringKey *a, std::size_t n, std::size_t depth)
+{
+    for(std::size_t i=1;i<n;i++)
+    {
+        StringKey v=a[i];
+        std::size_t j=i;
+        for(;j>0 && less_from(v,a[j-1],depth);j--) a[j]=a[j-1];
+        a[j]=v;
+    }
+}
+
+std::uint64_t median3(std::uint64_t x, std::uint64_t y, std::uint64_t z)
+{
+    if(x>y) std::swap(x,y);
+    if(y>z) std::swap(y,z);
+    return std::max(x,y);
+}
+
+//prefix у всех a[0..n) -- с глубины depth
+void mkqs(StringKey *a, std::size_t n, std::size_t depth)
+{
+    while(n>mkqs_threshold)
+    {
+        std::uint64_t p=median3(a[0].prefix,a[n/2].prefix,a[n-1].prefix);
+        std::size_t lt=0, i=0, gt=n;
+        while(i<gt)
+        {
+            if(a[i].prefix<p) std::swap(a[lt++],a[i++]);
+            else if(a[i].prefix>p) std::swap(a[i],a[--gt]);
+            else i++;
+        }
+        mkqs(a,lt,depth);
+        mkqs(a+gt,n-gt,depth);
+        //равные строки, кончившиеся в этих 8 байтах, совпадают целиком
+        if(ended(p)) return;
+        a+=lt;
+        n=gt-lt;
+        depth+=8;
+        reload(a,n,depth);
+    }
+    insertion(a,n,depth);
+}
+
+//prefix -- с глубины depth, все строки совпадают в первых depth+byte байтах
+void msd(StringKey *a, StringKey *tmp, std::size_t n, std::size_t depth, unsigned byte)
+{
+    std::size_t count[256];
+    for(;;)
+    {
+        if(n<string_radix_threshold) {
+            mkqs(a,n,depth);
+            return;
+        }
+        if(byte==8) {
+            depth+=8;
+            byte=0;
+            reload(a,n,depth);
+        }
+        unsigned shift=56-8*byte;
+        std::fill(count,count+256,0);
+        for(std::size_t i=0;i<n;i++) count[(a[i].prefix>>shift)&0xff]++;
+        if(count[0]==n) return;
+        //все в одной корзине -- сразу к следующему байту без перестановки
+        std::size_t d=0;
+        while(count[d]==0) d++;
+        if(count[d]!=n) break;
+        byte++;
+    }
+    std::size_t off[256], sum=0;
+    for(unsigned d=0;d<256;d++) { off[d]=sum; sum+=count[d]; }
+    unsigned shift=56-8*byte;
+    for(std::size_t i=0;i<n;i++) tmp[off[(a[i].prefix>>shift)&0xff]++]=a[i];
+    std::copy(tmp,tmp+n,a);
+    //корзина 0 -- строки, кончившиеся на этом байте: они равны
+    for(std::size_t d=1,lo=count[0];d<256;lo+=count[d],d++)
+        if(count[d]>1) msd(a+lo,tmp+lo,count[d],depth,byte+1);
+}
+
+}
+
+std::uint64_t load_key(const char *p)
+{
+    std::uint64_t x;
+    std::memcpy(&x,p,8);
+    //старшие биты нулевых байтов; самый младший из них -- точно терминатор
+    std::uint64_t z=(x-0x0101010101010101ull)&~x&0x8080808080808080ull;
+    if(z) x&=((z&(0-z))>>7)-1;
+    return __builtin_bswap64(x);
+}
+
+StringArena::StringArena(const char *text, std::size_t len)
+{
+    buf.reserve(len+9);
+    std::vector<std::size_t> at;
+    const char *end=text+len;
+    for(const char *p=text;p<end;)
+    {
+        const char *e=static_cast<const char*>(std::memchr(p,'\n',end-p));
+        if(e==nullptr) e=end;
+        const char *t=e;
+        if(t>p && t[-1]=='\r') t--;
+        at.push_back(buf.size());
+        buf.insert(buf.end(),p,t);
+        buf.push_back('\0');
+        p=e+1;
+    }
+    buf.insert(buf.end(),8,'\0');
+    k.resize(at.size());
+    for(std::size_t i=0;i<at.size();i++) k[i]={load_key(&buf[at[i]]),&buf[at[i]]};
+}
+
+StringArena::StringArena(const std::vector<std::string> &lines)
+{
+    std::size_t total=8;
+    for(auto &s : lines) total+=s.size()+1;
+    buf.reserve(total);
+    std::vector<std::size_t> at;
+    for(auto &s : lines)
+    {
+        at.push_back(buf.size());
+        buf.insert(buf.end(),s.begin(),s.end());
+        buf.push_back('\0');
+    }
+    buf.insert(buf.end(),8,'\0');
+    k.resize(at.size());
+    for(std::size_t i=0;i<at.size();i++) k[i]={load_key(&buf[at[i]]),&buf[at[i]]};
+}
+
+StringArena StringArena::read(const std::string &path)
+{
+    IntFile f(path);
+    return StringArena(f.bytes(),f.size());
+}
+
+void StringArena::write(const std::string &path) const
+{
+    std::ofstream out(path,std::ios::binary);
+    for(auto &x : k)
+    {
+        out<<x.s;
+        out.put('\n');
+    }
+    if(!out) throw std::runtime_error("не удалось записать "+path);
+}
+
+void multikey_sort(std::vector<StringKey> &v)
+{
+    mkqs(v.data(),v.size(),0);
+}
+
+void string_radix_sort(std::vector<StringKey> &v)
+{
+    std::vector<StringKey> tmp(v.size());
+    msd(v.data(),tmp.data(),v.size(),0,0);
+}
+
+}
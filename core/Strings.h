@@ -0,0 +1,65 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_STRINGS_H
+#define SORT_STRINGS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__!=__ORDER_LITTLE_ENDIAN__
+#error "load_key assumes a little-endian host"
+#endif
+
+namespace sortcore {
+
+//Строка в сортировке: 8 байт строки с текущей глубины как big-endian число
+//(после конца строки -- нули) и указатель на её начало в арене. Сортировки
+//двигают только эти 16 байт и сравнивают строки по 8 символов одним
+//сравнением чисел, заглядывая в арену, лишь когда префиксы совпали.
+struct StringKey{
+    std::uint64_t prefix;
+    const char *s;
+};
+
+//Все строки подряд в одном буфере, каждая завершена нулём, в конце -- 8
+//нулевых байт запаса, так что ключ любой глубины читается одним 8-байтным
+//чтением без проверки длины
+class StringArena{
+    std::vector<char> buf;
+    std::vector<StringKey> k;
+public:
+    //Строки текста, разделённые '\n' ('\r' перед ним отбрасывается)
+    StringArena(const char *text, std::size_t len);
+    explicit StringArena(const std::vector<std::string> &lines);
+    //Строки текстового файла
+    static StringArena read(const std::string &path);
+    StringArena(const StringArena&)=delete;
+    StringArena &operator=(const StringArena&)=delete;
+    StringArena(StringArena&&)=default;
+    std::size_t size() const { return k.size(); }
+    std::vector<StringKey> &keys() { return k; }
+    const std::vector<StringKey> &keys() const { return k; }
+    //Строки в текущем порядке ключей через '\n'
+    void write(const std::string &path) const;
+};
+
+//8 байт строки с позиции p; байты после завершающего нуля обнуляются
+std::uint64_t load_key(const char *p);
+
+//Трёхпутевая поразрядная быстрая сортировка (Бентли -- Седжвик) по
+//8-байтным "символам": разбиение на <, =, > по префиксу, и только равная
+//часть переходит к следующим 8 байтам
+void multikey_sort(std::vector<StringKey> &v);
+
+//MSD-сортировка по байтам: крупные корзины раскладываются подсчётом по
+//очередному байту префикса, мелкие досортировываются multikey_sort.
+//Дополнительная память -- буфер на n ключей.
+void string_radix_sort(std::vector<StringKey> &v);
+
+}
+
+#endif //SORT_STRINGS_H
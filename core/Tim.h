@@ -0,0 +1,442 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_TIM_H
+#define SORT_TIM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "Trace.h"
+
+namespace sortcore {
+
+namespace detail {
+
+//Короче этого массив сортируется одними двоичными вставками
+const std::ptrdiff_t tim_min_merge=32;
+//Столько побед одной серии подряд переводят слияние в режим галопа
+const std::ptrdiff_t tim_min_gallop=7;
+//Буфер слияния остаётся за потоком между вызовами, пока не больше этого
+const std::size_t tim_keep_bytes=1<<20;
+
+//Длина minrun из [tim_min_merge/2, tim_min_merge]: n/minrun -- степень
+//двойки или чуть меньше, чтобы слияния шли между сериями близкой длины
+inline std::ptrdiff_t min_run(std::ptrdiff_t n)
+{
+    std::ptrdiff_t r=0;
+    while(n>=tim_min_merge)
+    {
+        r|=n&1;
+        n>>=1;
+    }
+    return n+r;
+}
+
+//Буфер слияния, общий для всех сортировок одного типа в потоке
+template<class T>
+std::vector<T> &merge_buffer()
+{
+    static thread_local std::vector<T> buf;
+    return buf;
+}
+
+//Сортировка слиянием естественных серий в духе Timsort
+template<class RandomIt, class Compare, class Trace>
+class Tim{
+    typedef typename std::iterator_traits<RandomIt>::value_type T;
+    typedef typename std::vector<T>::iterator BufIt;
+    RandomIt a;
+    Compare &comp;
+    Trace &tr;
+    std::vector<T> &buf;
+    std::ptrdiff_t min_gallop=tim_min_gallop;
+    std::vector<std::pair<std::ptrdiff_t,std::ptrdiff_t>> runs; //(начало, длина)
+
+    void put(std::ptrdiff_t dest, T &&v)
+    {
+        a[dest]=std::move(v);
+        tr.write(dest,a[dest]);
+    }
+
+    //Вставки с двоичным поиском места в [lo, hi), где [lo, start) уже упорядочен;
+    //равные ставятся после имеющихся, так что порядок сохраняется
+    void binary_insertion(std::ptrdiff_t lo, std::ptrdiff_t hi, std::ptrdiff_t start)
+    {
+        for(std::ptrdiff_t i=std::max(start,lo+1);i<hi;i++)
+        {
+            std::ptrdiff_t l=lo, r=i;
+            while(l<r)
+            {
+                std::ptrdiff_t m=l+(r-l)/2;
+                tr.compare(i,m);
+                if(comp(a[i],a[m])) r=m;
+                else l=m+1;
+            }
+            if(l==i) continue;
+            T v=std::move(a[i]);
+            for(std::ptrdiff_t j=i;j>l;j--) put(j,std::move(a[j-1]));
+            put(l,std::move(v));
+        }
+    }
+
+    //Длина серии с начала lo; строго убывающая разворачивается на месте
+    std::ptrdiff_t count_run(std::ptrdiff_t lo, std::ptrdiff_t hi)
+    {
+        std::ptrdiff_t r=lo+1;
+        if(r==hi) return 1;
+        tr.compare(r,lo);
+        if(comp(a[r++],a[lo]))
+        {
+            while(r<hi)
+            {
+                tr.compare(r,r-1);
+                if(!comp(a[r],a[r-1])) break;
+                r++;
+            }
+            for(std::ptrdiff_t i=lo,j=r-1;i<j;i++,j--)
+            {
+                using std::swap;
+                swap(a[i],a[j]);
+                tr.swap(i,j);
+            }
+        }
+        else
+            while(r<hi)
+            {
+                tr.compare(r,r-1);
+                if(comp(a[r],a[r-1])) break;
+                r++;
+            }
+        return r-lo;
+    }
+
+    //Галоп: k, при котором s[k-1] < key <= s[k], поиск от позиции hint
+    //экспоненциальными шагами, затем двоичный. at -- индекс s[0] для трассы.
+    template<class It>
+    std::ptrdiff_t gallop_left(const T &key, It s, std::ptrdiff_t len, std::ptrdiff_t hint, std::ptrdiff_t at)
+    {
+        std::ptrdiff_t last=0, ofs=1;
+        tr.compare(at+hint,at+hint);
+        if(comp(s[hint],key))
+        {
+            std::ptrdiff_t max=len-hint;
+            while(ofs<max)
+            {
+                tr.compare(at+hint+ofs,at+hint+ofs);
+                if(!comp(s[hint+ofs],key)) break;
+                last=ofs;
+                ofs=2*ofs+1;
+            }
+            ofs=std::min(ofs,max);
+            last+=hint;
+            ofs+=hint;
+        }
+        else
+        {
+            std::ptrdiff_t max=hint+1;
+            while(ofs<max)
+            {
+                tr.compare(at+hint-ofs,at+hint-ofs);
+                if(comp(s[hint-ofs],key)) break;
+                last=ofs;
+                ofs=2*ofs+1;
+            }
+            ofs=std::min(ofs,max);
+            std::ptrdiff_t t=last;
+            last=hint-ofs;
+            ofs=hint-t;
+        }
+        for(last++;last<ofs;)
+        {
+            std::ptrdiff_t m=last+(ofs-last)/2;
+            tr.compare(at+m,at+m);
+            if(comp(s[m],key)) last=m+1;
+            else ofs=m;
+        }
+        return ofs;
+    }
+
+    //То же для s[k-1] <= key < s[k]
+    template<class It>
+    std::ptrdiff_t gallop_right(const T &key, It s, std::ptrdiff_t len, std::ptrdiff_t hint, std::ptrdiff_t at)
+    {
+        std::ptrdiff_t last=0, ofs=1;
+        tr.compare(at+hint,at+hint);
+        if(comp(key,s[hint]))
+        {
+            std::ptrdiff_t max=hint+1;
+            while(ofs<max)
+            {
+                tr.compare(at+hint-ofs,at+hint-ofs);
+                if(!comp(key,s[hint-ofs])) break;
+                last=ofs;
+                ofs=2*ofs+1;
+            }
+            ofs=std::min(ofs,max);
+            std::ptrdiff_t t=last;
+            last=hint-ofs;
+            ofs=hint-t;
+        }
+        else
+        {
+            std::ptrdiff_t max=len-hint;
+            while(ofs<max)
+            {
+                tr.compare(at+hint+ofs,at+hint+ofs);
+                if(comp(key,s[hint+ofs])) break;
+                last=ofs;
+                ofs=2*ofs+1;
+            }
+            ofs=std::min(ofs,max);
+            last+=hint;
+            ofs+=hint;
+        }
+        for(last++;last<ofs;)
+        {
+            std::ptrdiff_t m=last+(ofs-last)/2;
+            tr.compare(at+m,at+m);
+            if(comp(key,s[m])) ofs=m;
+            else last=m+1;
+        }
+        return ofs;
+    }
+
+    //Слияние, когда левая серия короче: она уходит в буфер, запись идёт слева.
+    //Известно, что a[b2] -- наименьший, а a[b1+n1-1] -- наибольший элемент.
+    void merge_lo(std::ptrdiff_t b1, std::ptrdiff_t n1, std::ptrdiff_t b2, std::ptrdiff_t n2)
+    {
+        buf.assign(std::make_move_iterator(a+b1),std::make_move_iterator(a+b1+n1));
+        BufIt t=buf.begin();
+        std::ptrdiff_t c1=0, c2=b2, dest=b1;
+        put(dest++,std::move(a[c2++]));
+        if(--n2==0) goto done;
+        if(n1==1) goto last;
+        for(;;)
+        {
+            std::ptrdiff_t w1=0, w2=0; //победы подряд
+            do {
+                tr.compare(c2,dest);
+                if(comp(a[c2],t[c1]))
+                {
+                    put(dest++,std::move(a[c2++]));
+                    w2++;
+                    w1=0;
+                    if(--n2==0) goto done;
+                }
+                else
+                {
+                    put(dest++,std::move(t[c1++]));
+                    w1++;
+                    w2=0;
+                    if(--n1==1) goto last;
+                }
+            } while((w1|w2)<min_gallop);
+            do {
+                w1=gallop_right(a[c2],t+c1,n1,0,dest);
+                for(std::ptrdiff_t k=0;k<w1;k++) put(dest++,std::move(t[c1++]));
+                n1-=w1;
+                if(n1==1) goto last;
+                //0 бывает лишь при несогласованном компараторе; last прочитал бы
+                //за концом буфера, а done просто оставляет остаток на месте
+                if(n1==0) goto done;
+                put(dest++,std::move(a[c2++]));
+                if(--n2==0) goto done;
+                w2=gallop_left(t[c1],a+c2,n2,0,c2);
+                for(std::ptrdiff_t k=0;k<w2;k++) put(dest++,std::move(a[c2++]));
+                n2-=w2;
+                if(n2==0) goto done;
+                put(dest++,std::move(t[c1++]));
+                if(--n1==1) goto last;
+                min_gallop--;
+            } while(w1>=tim_min_gallop || w2>=tim_min_gallop);
+            min_gallop=std::max<std::ptrdiff_t>(min_gallop,0)+2;
+        }
+    last:
+        //остался один элемент буфера, и он больше всего остатка правой серии
+        for(std::ptrdiff_t k=0;k<n2;k++) put(dest++,std::move(a[c2++]));
+        put(dest,std::move(t[c1]));
+        min_gallop=std::max<std::ptrdiff_t>(min_gallop,1);
+        return;
+    done:
+        for(;n1>0;n1--) put(dest++,std::move(t[c1++]));
+        min_gallop=std::max<std::ptrdiff_t>(min_gallop,1);
+    }
+
+    //Зеркально: правая серия короче, уходит в буфер, запись идёт справа
+    void merge_hi(std::ptrdiff_t b1, std::ptrdiff_t n1, std::ptrdiff_t b2, std::ptrdiff_t n2)
+    {
+        buf.assign(std::make_move_iterator(a+b2),std::make_move_iterator(a+b2+n2));
+        BufIt t=buf.begin();
+        std::ptrdiff_t c1=b1+n1-1, c2=n2-1, dest=b2+n2-1;
+        put(dest--,std::move(a[c1--]));
+        if(--n1==0) goto done;
+        if(n2==1) goto last;
+        for(;;)
+        {
+            std::ptrdiff_t w1=0, w2=0;
+            do {
+                tr.compare(dest,c1);
+                if(comp(t[c2],a[c1]))
+                {
+                    put(dest--,std::move(a[c1--]));
+                    w1++;
+                    w2=0;
+                    if(--n1==0) goto done;
+                }
+                else
+                {
+                    put(dest--,std::move(t[c2--]));
+                    w2++;
+                    w1=0;
+                    if(--n2==1) goto last;
+                }
+            } while((w1|w2)<min_gallop);
+            do {
+                w1=n1-gallop_right(t[c2],a+b1,n1,n1-1,b1);
+                for(std::ptrdiff_t k=0;k<w1;k++) put(dest--,std::move(a[c1--]));
+                n1-=w1;
+                if(n1==0) goto done;
+                put(dest--,std::move(t[c2--]));
+                if(--n2==1) goto last;
+                w2=n2-gallop_left(a[c1],t,n2,n2-1,dest-n2+1);
+                for(std::ptrdiff_t k=0;k<w2;k++) put(dest--,std::move(t[c2--]));
+                n2-=w2;
+                if(n2==1) goto last;
+                if(n2==0) goto done; //несогласованный компаратор, как в merge_lo
+                put(dest--,std::move(a[c1--]));
+                if(--n1==0) goto done;
+                min_gallop--;
+            } while(w1>=tim_min_gallop || w2>=tim_min_gallop);
+            min_gallop=std::max<std::ptrdiff_t>(min_gallop,0)+2;
+        }
+    last:
+        //остался один элемент буфера, и он меньше всего остатка левой серии
+        for(std::ptrdiff_t k=0;k<n1;k++) put(dest--,std::move(a[c1--]));
+        put(dest,std::move(t[c2]));
+        min_gallop=std::max<std::ptrdiff_t>(min_gallop,1);
+        return;
+    done:
+        for(;n2>0;n2--) put(dest--,std::move(t[c2--]));
+        min_gallop=std::max<std::ptrdiff_t>(min_gallop,1);
+    }
+
+    //Сливает серии i и i+1 стека
+    void merge_at(std::size_t i)
+    {
+        std::ptrdiff_t b1=runs[i].first, n1=runs[i].second, b2=runs[i+1].first, n2=runs[i+1].second;
+        runs[i].second=n1+n2;
+        runs.erase(runs.begin()+i+1);
+        tr.run(b1,b2+n2);
+        //начало левой серии, что не больше a[b2], и хвост правой, что не меньше
+        //конца левой, уже на своих местах
+        std::ptrdiff_t k=gallop_right(a[b2],a+b1,n1,0,b1);
+        b1+=k;
+        n1-=k;
+        if(n1==0) return;
+        n2=gallop_left(a[b1+n1-1],a+b2,n2,n2-1,b2);
+        if(n2==0) return;
+        if(n1<=n2) merge_lo(b1,n1,b2,n2);
+        else merge_hi(b1,n1,b2,n2);
+    }
+
+    //Держит длины серий на стеке растущими быстрее Фибоначчи, так что
+    //стек логарифмический, а сливаются серии близкой длины. Проверяются три
+    //верхних серии, а не две: иначе инвариант может нарушиться глубже.
+    void collapse()
+    {
+        while(runs.size()>1)
+        {
+            std::ptrdiff_t n=(std::ptrdiff_t)runs.size()-2;
+            auto len=[this](std::ptrdiff_t i) { return runs[i].second; };
+            if((n>0 && len(n-1)<=len(n)+len(n+1)) || (n>1 && len(n-2)<=len(n-1)+len(n)))
+            {
+                if(len(n-1)<len(n+1)) n--;
+            }
+            else if(len(n)>len(n+1)) break;
+            merge_at(n);
+        }
+    }
+
+    void force_collapse()
+    {
+        while(runs.size()>1)
+        {
+            std::size_t n=runs.size()-2;
+            if(n>0 && runs[n-1].second<runs[n+1].second) n--;
+            merge_at(n);
+        }
+    }
+
+public:
+    Tim(RandomIt a, Compare &comp, Trace &tr) : a(a), comp(comp), tr(tr), buf(merge_buffer<T>()) {}
+
+    ~Tim()
+    {
+        buf.clear();
+        if(buf.capacity()*sizeof(T)>tim_keep_bytes) buf.shrink_to_fit();
+    }
+
+    void sort(std::ptrdiff_t lo, std::ptrdiff_t hi)
+    {
+        std::ptrdiff_t n=hi-lo;
+        if(n<2) return;
+        if(n<tim_min_merge)
+        {
+            std::ptrdiff_t r=count_run(lo,hi);
+            binary_insertion(lo,hi,lo+r);
+            return;
+        }
+        std::ptrdiff_t minrun=min_run(n);
+        while(lo<hi)
+        {
+            std::ptrdiff_t r=count_run(lo,hi);
+            if(r<minrun)
+            {
+                //короткую серию добираем вставками до minrun
+                std::ptrdiff_t force=std::min(minrun,hi-lo);
+                binary_insertion(lo,lo+force,lo+r);
+                r=force;
+            }
+            runs.emplace_back(lo,r);
+            tr.run(lo,lo+r);
+            collapse();
+            lo+=r;
+        }
+        force_collapse();
+    }
+};
+
+}
+
+//Устойчивая адаптивная сортировка слиянием: естественные серии (убывающие
+//разворачиваются), короткие добираются вставками до minrun, слияние с
+//галопом. На упорядоченных кусках -- O(n), в худшем случае -- O(n log n)
+//сравнений и n/2 дополнительной памяти. Серии и результаты слияний сообщаются
+//трассе через run(lo, hi).
+template<class RandomIt, class Compare, class Trace>
+void tim_sort(RandomIt first, RandomIt last, Compare comp, Trace &tr)
+{
+    detail::Tim<RandomIt,Compare,Trace>(first,comp,tr).sort(0,last-first);
+}
+
+template<class RandomIt, class Compare>
+void tim_sort(RandomIt first, RandomIt last, Compare comp)
+{
+    NoTrace tr;
+    tim_sort(first,last,comp,tr);
+}
+
+template<class RandomIt>
+void tim_sort(RandomIt first, RandomIt last)
+{
+    tim_sort(first,last,std::less<>());
+}
+
+}
+
+#endif //SORT_TIM_H
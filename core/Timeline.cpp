@@ -0,0 +1,115 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#include "Timeline.h"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace sortcore {
+
+const std::size_t Timeline::max_size;
+
+Timeline::Timeline(std::vector<int> initial, std::size_t period)
+    : period(period ? period : std::max<std::size_t>(64,initial.size())), work(std::move(initial))
+{
+    if(work.size()>max_size) throw std::runtime_error("массив слишком велик для трассировки");
+    note("Исходный массив");
+}
+
+void Timeline::push(Kind kind, std::size_t i, int arg)
+{
+    //индекс делит 32 бита с видом операции
+    if(i>=max_size) throw std::runtime_error("индекс вне трассируемого массива");
+    //к этому моменту work всегда соответствует концу трассы
+    Delta x{std::uint32_t(kind)<<30 | std::uint32_t(i), arg};
+    d.push_back(x);
+    apply(x);
+    pos=d.size()-1;
+    if(pos%period==0) keys.push_back(work);
+}
+
+void Timeline::apply(const Delta &x)
+{
+    switch(kind(x))
+    {
+        case Swap: std::swap(work[index(x)],work[x.arg]); break;
+        case Write: work[index(x)]=x.arg; break;
+        case Note: case Run: break;
+    }
+}
+
+void Timeline::swap(std::size_t i, std::size_t j)
+{
+    at(size()-1);
+    push(Swap,i,(int)j);
+}
+
+void Timeline::write(std::size_t i, int v)
+{
+    at(size()-1);
+    push(Write,i,v);
+}
+
+void Timeline::note(std::string text)
+{
+    if(!d.empty()) at(size()-1);
+    notes.push_back(std::move(text));
+    push(Note,0,(int)notes.size()-1);
+}
+
+void Timeline::run(std::size_t lo, std::size_t hi)
+{
+    at(size()-1);
+    push(Run,lo,(int)hi);
+}
+
+const std::vector<int> &Timeline::at(std::size_t k)
+{
+    if(k<pos || k-pos>period)
+    {
+        work=keys[k/period];
+        pos=k/period*period;
+    }
+    for(;pos<k;) apply(d[++pos]);
+    return work;
+}
+
+std::pair<int,int> Timeline::touched(std::size_t k) const
+{
+    const Delta &x=d[k];
+    switch(kind(x))
+    {
+        case Swap: return {index(x),x.arg};
+        case Write: return {index(x),index(x)};
+        case Run: return {index(x),x.arg-1};
+        case Note: break;
+    }
+    return {-1,-1};
+}
+
+std::string Timeline::text(std::size_t k) const
+{
+    const Delta &x=d[k];
+    char buf[64];
+    switch(kind(x))
+    {
+        case Swap: std::snprintf(buf,sizeof(buf),"Обмен a[%d] и a[%d]",index(x),x.arg); return buf;
+        case Write: std::snprintf(buf,sizeof(buf),"Запись a[%d] = %d",index(x),x.arg); return buf;
+        case Run: std::snprintf(buf,sizeof(buf),"Серия a[%d..%d]",index(x),x.arg-1); return buf;
+        case Note: break;
+    }
+    return notes[x.arg];
+}
+
+State Timeline::state(std::size_t k)
+{
+    State s;
+    s.cur=at(k);
+    std::snprintf(s.statestr,sizeof(s.statestr),"%s",text(k).c_str());
+    s.sw=touched(k);
+    return s;
+}
+
+}
@@ -0,0 +1,79 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_TIMELINE_H
+#define SORT_TIMELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "State.h"
+#include "Trace.h"
+
+namespace sortcore {
+
+//Трасса сортировки в виде дельт (обмен, запись, серия, подпись) с ключевыми кадрами.
+//Шаг k -- массив после применения дельт [0..k]. Каждые period дельт хранится
+//полная копия массива, так что любой шаг восстанавливается за O(n + period),
+//а память растёт как 8 байт на операцию плюс n/period копий. На индекс в
+//дельте 30 бит: массив длиннее max_size -- std::runtime_error.
+class Timeline{
+    enum Kind{Swap, Write, Note, Run};
+    //2 старших бита -- вид операции, остальные -- индекс
+    struct Delta{
+        std::uint32_t op;
+        std::int32_t arg;
+    };
+    std::vector<Delta> d;
+    std::vector<std::vector<int>> keys;
+    std::vector<std::string> notes;
+    std::size_t period;
+    std::vector<int> work;
+    std::size_t pos=0;
+    void push(Kind kind, std::size_t i, int arg);
+    void apply(const Delta &x);
+    static Kind kind(const Delta &x) { return Kind(x.op>>30); }
+    static int index(const Delta &x) { return int(x.op&0x3fffffffu); }
+public:
+    static const std::size_t max_size=std::size_t(1)<<30;
+    //period=0 -- выбрать автоматически (не меньше длины массива)
+    explicit Timeline(std::vector<int> initial, std::size_t period=0);
+    void swap(std::size_t i, std::size_t j);
+    void write(std::size_t i, int v);
+    void note(std::string text);
+    //Упорядоченная серия [lo, hi); массив не меняется
+    void run(std::size_t lo, std::size_t hi);
+    std::size_t size() const { return d.size(); }
+    //Массив на шаге k; ссылка действительна до следующего вызова
+    const std::vector<int> &at(std::size_t k);
+    //Затронутая на шаге k пара индексов, границы для серии, {-1,-1} для подписи
+    std::pair<int,int> touched(std::size_t k) const;
+    std::string text(std::size_t k) const;
+    State state(std::size_t k);
+};
+
+//Трассировка в Timeline
+class TimelineTrace{
+    Timeline &tl;
+public:
+    static constexpr bool enabled=true;
+    Stats stats;
+    explicit TimelineTrace(Timeline &tl) : tl(tl) {}
+    void compare(std::ptrdiff_t, std::ptrdiff_t) {++stats.comparisons;}
+    void swap(std::ptrdiff_t i, std::ptrdiff_t j) {
+        ++stats.swaps;
+        tl.swap(i,j);
+    }
+    template<class T> void write(std::ptrdiff_t i, const T &v) {
+        ++stats.writes;
+        tl.write(i,(int)v);
+    }
+    void run(std::ptrdiff_t lo, std::ptrdiff_t hi) {tl.run(lo,hi);}
+};
+
+}
+
+#endif //SORT_TIMELINE_H
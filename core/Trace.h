@@ -0,0 +1,43 @@
+//
+// Created by andrew on 18.10.26.
+//
+
+#ifndef SORT_TRACE_H
+#define SORT_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sortcore {
+
+struct Stats{
+    std::uint64_t comparisons=0, swaps=0, writes=0;
+};
+
+//Политики трассировки. Ядра сортировок вызывают compare/swap/write после
+//каждой операции над массивом; индексы считаются от начала сортируемого диапазона.
+//Сортировки слиянием вдобавок сообщают через run(lo, hi) упорядоченную серию
+//[lo, hi) или отрезок, который сейчас станет ею после слияния.
+
+//Трассировка выключена: все вызовы пустые и полностью исчезают после инлайнинга
+struct NoTrace{
+    static constexpr bool enabled=false;
+    void compare(std::ptrdiff_t, std::ptrdiff_t) {}
+    void swap(std::ptrdiff_t, std::ptrdiff_t) {}
+    template<class T> void write(std::ptrdiff_t, const T&) {}
+    void run(std::ptrdiff_t, std::ptrdiff_t) {}
+};
+
+//Только счётчики операций
+struct CountTrace{
+    static constexpr bool enabled=true;
+    Stats stats;
+    void compare(std::ptrdiff_t, std::ptrdiff_t) {++stats.comparisons;}
+    void swap(std::ptrdiff_t, std::ptrdiff_t) {++stats.swaps;}
+    template<class T> void write(std::ptrdiff_t, const T&) {++stats.writes;}
+    void run(std::ptrdiff_t, std::ptrdiff_t) {}
+};
+
+}
+
+#endif //SORT_TRACE_H